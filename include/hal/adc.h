@@ -4,12 +4,27 @@
 /*
  *  RP2040 ADC LL Driver
  *  Martin Kopka 2022
+ *
+ *  adc_read() converts a single sample on request. For continuous acquisition, adc_capture_start() runs the ADC free (START_MANY)
+ *  at a rate set by the clock divider, optionally scanning several inputs in round-robin order. The results are written to the
+ *  FIFO, from which two chained DMA channels move them alternately into two sample blocks; while one block is being filled,
+ *  the other one is passed to the block callback. At 48 MHz clk_adc the ADC reaches 500 ksps with no CPU load.
+ *  Blocks of a power-of-two size (at most 32 kB) aligned to their size are rearmed by the write ring of the DMA, so a late DMA IRQ only delays
+ *  the callback. Other blocks are rearmed by the DMA IRQ; if it is late by a whole block, the capture is stopped before memory behind
+ *  the block is overwritten any further. Both cases are reported by adc_capture_overrun().
+ *  adc_read() must not be used while capturing.
 */
 
 #include "rp2040.h"
 #include "hal/resets.h"
 #include "hal/clocks.h"
 
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define ADC_CONVERSION_CYCLES   96      // clk_adc cycles of one conversion; the shortest sample period
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
 enum adc_channel_t {
 
     ADC0 = 0,
@@ -19,8 +34,30 @@ enum adc_channel_t {
     ADC4 = 4    // temperature sensor
 };
 
+//---- TYPES -----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// block callback of a capture; called from the DMA IRQ with the block that has just been filled (buffer 0 or 1)
+typedef void (*adc_callback_t)(uint16_t *block, uint8_t buffer);
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
+// sets the sample rate of the free-running mode; returns the exact sample rate [Hz]. Rates above clk_adc / 96 run the conversions back-to-back
+uint32_t adc_set_sample_rate(uint32_t sample_rate);
+
+// starts a continuous capture of the inputs in channel_mask (bit 0 = ADC0 .. bit 4 = ADC4) into two blocks of count samples each;
+// multiple inputs are sampled in round-robin order starting from the lowest one, so the samples of the inputs are interleaved in the blocks.
+// sample_rate is the total rate of all inputs. Returns false if the capture is running, the mask is empty or no DMA channels are available
+bool adc_capture_start(uint8_t channel_mask, uint32_t sample_rate, uint16_t *block_0, uint16_t *block_1, uint32_t count, adc_callback_t callback);
+
+// stops the capture; the block being filled is discarded
+void adc_capture_stop(void);
+
+// returns true if samples were lost since the last call: the FIFO has overflowed (the DMA did not keep up) or a block was refilled before
+// its callback ran (the DMA IRQ did not keep up; without the write ring this stops the capture); clears the flags
+bool adc_capture_overrun(void);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
 // initializes the ADC; pll_usb needs to be setup beforehand
 static inline void adc_init() {
 
@@ -30,18 +67,18 @@ static inline void adc_init() {
 	resets_reset_block(RESETS_ADC);
     resets_unreset_block(RESETS_ADC);
 
-	set_bits(ADC->CS, ADC_CS_EN);
+	atomic_set_bits(ADC->CS, ADC_CS_EN);
 	while(bit_is_clear(ADC->CS, ADC_CS_READY));
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 // reads a sample from the specified ADC channel, waits for the result, then returns it
-static volatile uint32_t adc_read(enum adc_channel_t channel) {
+static uint32_t adc_read(enum adc_channel_t channel) {
 
-    write_masked(ADC->CS, channel, ADC_CS_AINSEL_MASK, ADC_CS_AINSEL_LSB);
+    atomic_write_masked(ADC->CS, channel, ADC_CS_AINSEL_MASK, ADC_CS_AINSEL_LSB);
 
-	set_bits(ADC->CS, ADC_CS_START_ONCE);
+	atomic_set_bits(ADC->CS, ADC_CS_START_ONCE);
 	while(bit_is_clear(ADC->CS, ADC_CS_READY));
 
     return ADC->RESULT;
@@ -4,9 +4,14 @@
 /*
  *  RP2040 clocks LL Driver
  *  Martin Kopka 2022
+ *
+ *  The frequencies of the clocks are kept in a cache, so the drivers can calculate their divisors without measuring the clocks.
+ *  clocks_configure() fills the cache with the exact frequencies resulting from the PLL settings; a clock not configured by it
+ *  is measured by the frequency counter once, the first time its frequency is requested.
 */
 
 #include "rp2040.h"
+#include "hal/pll.h"
 
 //---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -79,11 +84,23 @@ enum clock_src_t {
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
+// starts the XOSC and runs the clocks from it: clk_ref from the XOSC, clk_sys and clk_peri from the system PLL, clk_usb and clk_adc from the USB PLL
+// (48 MHz required) and clk_rtc from the USB PLL divided by 1024; the resulting frequencies are stored in the frequency cache
+void clocks_configure(uint32_t xosc_hz, pll_config_t sys_pll, pll_config_t usb_pll);
+
+// returns the frequency of the clock [Hz]; measured by the frequency counter the first time if it has not been configured by clocks_configure() or clocks_set_hz()
+uint32_t clocks_get_hz(enum clock_instance clk);
+
+// stores the frequency of a clock configured by the application to the frequency cache
+void clocks_set_hz(enum clock_instance clk, uint32_t hz);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
 // enables or disables the clock
 static volatile void clocks_set_enable(enum clock_instance clk, bool enabled) {
 
-    if (enabled) set_bits(CLOCKS->CLK[clk].CTRL, CLK_CTRL_ENABLE);
-    else       clear_bits(CLOCKS->CLK[clk].CTRL, CLK_CTRL_ENABLE);
+    if (enabled) atomic_set_bits(CLOCKS->CLK[clk].CTRL, CLK_CTRL_ENABLE);
+    else       atomic_clear_bits(CLOCKS->CLK[clk].CTRL, CLK_CTRL_ENABLE);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -91,7 +108,7 @@ static volatile void clocks_set_enable(enum clock_instance clk, bool enabled) {
 // selects the glitchless mux source of a clock
 static volatile void clocks_set_source(enum clock_instance clk, enum clock_src_t src) {
 
-	write_masked(CLOCKS->CLK[clk].CTRL, src, CLK_CTRL_SRC_MASK, CLK_CTRL_SRC_LSB);
+	atomic_write_masked(CLOCKS->CLK[clk].CTRL, src, CLK_CTRL_SRC_MASK, CLK_CTRL_SRC_LSB);
     while (CLOCKS->CLK[clk].SELECTED != (1 << src));
 }
 
@@ -101,7 +118,15 @@ static volatile void clocks_set_source(enum clock_instance clk, enum clock_src_t
 // Switching a running clock will generate glitches, that could corrupt the state of the peripheral's logic
 static volatile void clocks_set_aux_source(enum clock_instance clk, enum clock_auxsrc_t auxsrc) {
 
-    write_masked(CLOCKS->CLK[clk].CTRL, auxsrc, CLK_CTRL_AUXSRC_MASK, CLK_CTRL_AUXSRC_LSB);
+    atomic_write_masked(CLOCKS->CLK[clk].CTRL, auxsrc, CLK_CTRL_AUXSRC_MASK, CLK_CTRL_AUXSRC_LSB);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the integer divisor of a clock
+static inline void clocks_set_div(enum clock_instance clk, uint32_t div) {
+
+    CLOCKS->CLK[clk].DIV = div << CLK_DIV_INT_LSB;
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,49 @@
+#ifndef _HAL_CRC_H_
+#define _HAL_CRC_H_
+
+/*
+ *  RP2040 Hardware checksums
+ *  Martin Kopka 2024
+ *
+ *  The DMA sniffer calculates a checksum of the data transferred by one channel without using the CPU. The results are bit-exact
+ *  with the software reference in utils/crc.h:
+ *
+ *  • crc_crc32:        CRC-32 (IEEE 802.3, zlib); the sniffer runs on bit reversed data and reverses and inverts the result on read
+ *  • crc_crc16_ccitt:  CRC-16/CCITT-FALSE
+ *  • crc_sum:          32-bit sum of the bytes
+ *
+ *  crc_calculate() checksums a buffer with a memory-to-null transfer; word-aligned buffers are read in 32-bit transfers (except for
+ *  the sum, which adds bytes). If the sniffer or a channel is not available, the software reference is used instead.
+ *
+ *  crc_sniff_start() attaches the sniffer to a channel of a peripheral transfer (UART, SPI), so the checksum is a free side effect
+ *  of the transfer. The channel must transfer bytes for the result to match the software reference.
+*/
+
+#include "rp2040.h"
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+enum crc_type {
+
+    crc_crc32       = 0x00,
+    crc_crc16_ccitt = 0x01,
+    crc_sum         = 0x02
+};
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the checksum (enum crc_type) of len bytes; blocks until the calculation is finished
+uint32_t crc_calculate(uint8_t type, const void *data, uint32_t len);
+
+// starts calculating the checksum (enum crc_type) of the transfers of a claimed DMA channel; returns false if the sniffer is in use
+bool crc_sniff_start(uint8_t channel, uint8_t type);
+
+// returns the checksum of the data transferred since crc_sniff_start()
+uint32_t crc_sniff_result(uint8_t type);
+
+// detaches the sniffer from the channel and releases it
+void crc_sniff_stop(uint8_t channel);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_CRC_H_ */
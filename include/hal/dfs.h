@@ -0,0 +1,63 @@
+#ifndef _HAL_DFS_H_
+#define _HAL_DFS_H_
+
+/*
+ *  RP2040 Dynamic Frequency Scaling
+ *  Martin Kopka 2024
+ *
+ *  Changes the clk_sys frequency at runtime. The system PLL is relocked while clk_sys runs from clk_ref, so the CPU keeps running
+ *  through the transition. The core voltage is raised before the clock goes up and lowered only after it has gone down.
+ *  clk_peri follows clk_sys when it is sourced from it. The drivers using the clocks (UART, SPI, I2C) register a notifier
+ *  and recalculate their divisors after the change; the application can register its own notifiers for the other peripherals.
+ *  Frequencies below the lowest PLL output (VCO 750 MHz / 49) are reached with the integer divider of clk_sys behind a faster PLL setting.
+ *  The transition latency is measured with the TIMER, which runs from the clk_ref based watchdog tick and so is not affected.
+*/
+
+#include "rp2040.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef DFS_MAX_NOTIFIERS
+#define DFS_MAX_NOTIFIERS       8       // maximum number of registered notifiers
+#endif
+
+#ifndef DFS_TOLERANCE_PERCENT
+#define DFS_TOLERANCE_PERCENT   1       // largest deviation of the reachable clk_sys frequency from the requested one [%]
+#endif
+
+#ifndef DFS_VREG_SETTLE_US
+#define DFS_VREG_SETTLE_US      1000    // time for the core voltage to settle after it has been raised [us]
+#endif
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+enum dfs_event {
+
+    dfs_pre_change  = 0x00,     // clk_sys is about to change; transfers in progress should be finished
+    dfs_post_change = 0x01      // clk_sys has changed; the clock divisors must be recalculated
+};
+
+//---- TYPES -----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// clock change notifier; clk_sys_hz is the new frequency of clk_sys. Called from thread mode with the IRQs enabled, so a notifier may wait for its driver IRQ
+typedef void (*dfs_notifier_t)(enum dfs_event event, uint32_t clk_sys_hz);
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// registers a notifier called before and after each clk_sys change; registering the same notifier again has no effect. Returns false if there is no free slot
+bool dfs_register_notifier(dfs_notifier_t notifier);
+
+// removes a registered notifier
+void dfs_unregister_notifier(dfs_notifier_t notifier);
+
+// changes the clk_sys frequency to the nearest frequency the system PLL and the clk_sys integer divider can generate from clk_ref;
+// must be called from thread mode with the IRQs enabled, because the notifiers wait for transfers finished by the driver IRQs. Returns the transition
+// latency [us] or 0 if called from an IRQ or with the IRQs masked, or if no frequency within DFS_TOLERANCE_PERCENT can be reached
+uint32_t dfs_set_sys_hz(uint32_t target_hz);
+
+// returns the latency of the last successful transition [us]
+uint32_t dfs_get_last_latency_us(void);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_DFS_H_ */
@@ -1,8 +1,46 @@
 #ifndef _HAL_DIVIDER_H_
 #define _HAL_DIVIDER_H_
 
+/*
+ *  RP2040 Hardware divider
+ *  Martin Kopka 2024
+ *
+ *  The compiler's 32-bit division helpers (__aeabi_uidiv, __aeabi_idiv and the divmod variants) run on the SIO divider in 8 cycles.
+ *  They save and restore the divider state when they find an interrupted division in progress (CSR_DIRTY), so they may be used from IRQs.
+ *  The 64-bit helpers (__aeabi_uldivmod, __aeabi_ldivmod) reduce the division to 32-bit steps executed by the divider.
+ *
+ *  The inline divider_divmod_*() functions don't check the state: an IRQ handler using them while the interrupted code may be dividing
+ *  has to save the divider state in its prologue with divider_save_state() and restore it with divider_restore_state() before returning.
+*/
+
 #include "rp2040.h"
 
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+// state of the divider; operands and results
+typedef struct {
+
+    uint32_t dividend;
+    uint32_t divisor;
+    uint32_t remainder;
+    uint32_t quotient;
+
+} divider_state_t;
+
+typedef struct {
+
+    uint32_t quotient;
+    uint32_t remainder;
+
+} divmod_u32_t;
+
+typedef struct {
+
+    int32_t quotient;
+    int32_t remainder;
+
+} divmod_s32_t;
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
 uint32_t __aeabi_uidiv(uint32_t numerator, uint32_t denominator);
@@ -11,6 +49,88 @@ uint32_t __aeabi_uidivmod(uint32_t numerator, uint32_t denominator);
 uint32_t __aeabi_idiv(uint32_t numerator, uint32_t denominator);
 uint32_t __aeabi_idivmod(uint32_t numerator, uint32_t denominator);
 
+// divides 64-bit unsigned numbers; the remainder is stored to *remainder (may be 0). Division by zero returns all ones and the numerator as the remainder
+uint64_t divider_divmod_u64(uint64_t numerator, uint64_t denominator, uint64_t *remainder);
+
+// divides 64-bit signed numbers, rounding towards zero; the remainder has the sign of the numerator and is stored to *remainder (may be 0)
+int64_t divider_divmod_s64(int64_t numerator, int64_t denominator, int64_t *remainder);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// waits the 8 cycles the divider needs to finish a calculation
+static force_inline void divider_wait(void) {
+
+    __asm volatile ("b 1f\n1: b 1f\n1: b 1f\n1: b 1f\n1:" ::: "memory");
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// divides unsigned numbers and returns the quotient and the remainder of the single calculation
+static force_inline divmod_u32_t divider_divmod_u32(uint32_t dividend, uint32_t divisor) {
+
+    SIO->DIV_UDIVIDEND = dividend;
+    SIO->DIV_UDIVISOR = divisor;
+    divider_wait();
+
+    // the remainder first, reading the quotient clears CSR_DIRTY
+    divmod_u32_t result;
+    result.remainder = SIO->DIV_REMAINDER;
+    result.quotient = SIO->DIV_QUOTIENT;
+
+    return result;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// divides signed numbers and returns the quotient and the remainder of the single calculation
+static force_inline divmod_s32_t divider_divmod_s32(int32_t dividend, int32_t divisor) {
+
+    SIO->DIV_SDIVIDEND = dividend;
+    SIO->DIV_SDIVISOR = divisor;
+    divider_wait();
+
+    divmod_s32_t result;
+    result.remainder = SIO->DIV_REMAINDER;
+    result.quotient = SIO->DIV_QUOTIENT;
+
+    return result;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the divider holds the state of a division whose results have not been read yet
+static inline bool divider_is_dirty(void) {
+
+    return (bit_is_set(SIO->DIV_CSR, SIO_DIV_CSR_DIRTY));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// saves the divider state; to be used in the prologue of an IRQ handler that uses the divider directly
+static force_inline void divider_save_state(divider_state_t *state) {
+
+    // a calculation started by the interrupted code may still be running
+    while (bit_is_clear(SIO->DIV_CSR, SIO_DIV_CSR_READY));
+
+    state->dividend = SIO->DIV_UDIVIDEND;
+    state->divisor = SIO->DIV_UDIVISOR;
+    state->remainder = SIO->DIV_REMAINDER;
+    state->quotient = SIO->DIV_QUOTIENT;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// restores the divider state saved by divider_save_state(); writing the operands restarts the calculation, so the results are written after it has finished
+static force_inline void divider_restore_state(const divider_state_t *state) {
+
+    SIO->DIV_UDIVIDEND = state->dividend;
+    SIO->DIV_UDIVISOR = state->divisor;
+    divider_wait();
+
+    SIO->DIV_REMAINDER = state->remainder;
+    SIO->DIV_QUOTIENT = state->quotient;
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #endif /* _HAL_DIVIDER_H_ */
@@ -0,0 +1,348 @@
+#ifndef _HAL_DMA_H_
+#define _HAL_DMA_H_
+
+/*
+ *  RP2040 DMA LL Driver
+ *  Martin Kopka 2024
+ *
+ *  Channels are claimed by drivers at runtime, so multiple drivers can share the DMA block without fixed channel assignments.
+ *  Completion interrupts are routed to DMA_IRQ0 by default and dispatched to per-channel callbacks; a channel can be moved to
+ *  DMA_IRQ1 with dma_channel_set_irq_line(), e.g. to keep a latency-critical stream apart from the bulk transfers.
+ *
+ *  A channel is either configured with a raw CTRL word (dma_channel_configure) or with a dma_channel_config_t, which starts from
+ *  dma_channel_default_config() and changes only the fields that differ.
+ *
+ *  dma_memcpy_async() and dma_memset_async() move large buffers with an unpaced channel in 32-bit transfers while the CPU continues.
+ *  The unaligned head and tail bytes and copies shorter than DMA_ASYNC_MIN_LEN are done by the CPU before the function returns,
+ *  since setting up the channel and taking its interrupt costs more than copying a short buffer with the LDM/STM memcpy().
+ *
+ *  Scatter-gather: a control channel copies descriptors from an array into the AL3 registers (CTRL, WRITE_ADDR, TRANS_COUNT,
+ *  READ_ADDR_TRIG) of a data channel, wrapping its write address on the 16-byte register block. The data channel chains back
+ *  to the control channel after each segment, so the whole list runs without the CPU. The list ends with a null descriptor,
+ *  whose null trigger stops the data channel and, with IRQ_QUIET set on all segments, raises the only interrupt of the list.
+ *
+ *  The sniffer observes the transfers of one channel at a time; it is claimed like a channel (see hal/crc.h for the checksums).
+*/
+
+#include "rp2040.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef DMA_ASYNC_MIN_LEN
+#define DMA_ASYNC_MIN_LEN       128     // shortest buffer moved by the DMA in dma_memcpy_async() and dma_memset_async() [bytes]
+#endif
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// size of one bus transfer
+enum dma_data_size {
+
+    dma_size_8  = 0x00,
+    dma_size_16 = 0x01,
+    dma_size_32 = 0x02
+};
+
+// interrupt lines of the DMA block
+enum dma_irq_line {
+
+    dma_irq_0 = 0x00,       // DMA_IRQ0 (default)
+    dma_irq_1 = 0x01        // DMA_IRQ1
+};
+
+//---- TYPES -----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// channel completion callback; called from the DMA IRQ handler
+typedef void (*dma_callback_t)(uint8_t channel);
+
+// channel configuration; translated to the CTRL register by dma_channel_config_ctrl()
+typedef struct {
+
+    uint8_t data_size;          // enum dma_data_size
+    bool    incr_read;          // the read address increments with each transfer
+    bool    incr_write;         // the write address increments with each transfer
+    uint8_t ring_size_bits;     // the address wraps on a (1 << ring_size_bits) byte boundary; 0 disables the wrapping
+    bool    ring_write;         // the ring applies to the write address instead of the read address
+    uint8_t dreq;               // transfer request signal (DMA_DREQ_x)
+    uint8_t chain_to;           // channel triggered when this channel completes; the channel itself disables chaining
+    bool    high_priority;      // the channel is preferred in the issue scheduling
+    bool    bswap;              // the bytes of each transfer are reversed
+    bool    irq_quiet;          // the IRQ is raised only when a null trigger ends a control block chain
+    bool    sniff;              // the transfers are visible to the sniffer
+
+} dma_channel_config_t;
+
+// handle of an asynchronous memory operation; must stay valid until the operation completes
+typedef struct {
+
+    volatile bool busy;         // true while the DMA transfer is in progress
+    int8_t   channel;           // channel of the transfer; -1 if the operation was done by the CPU
+    uint32_t pattern;           // fill word of dma_memset_async(); read by the DMA during the transfer
+
+} dma_async_t;
+
+// scatter-gather descriptor; the layout matches the AL3 registers of a channel
+typedef struct {
+
+    uint32_t ctrl;                          // CTRL register of the data channel; built by dma_sg_set()
+    volatile void *write_addr;              // write address of the segment
+    uint32_t transfer_count;                // number of transfers of the segment
+    const volatile void *read_addr;         // read address of the segment; 0 ends the list
+
+} dma_sg_descriptor_t;
+
+// scatter-gather channel pair
+typedef struct {
+
+    int8_t control_channel;                 // loads the descriptors into the data channel
+    int8_t data_channel;                    // transfers the segments
+
+} dma_sg_t;
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// initializes the DMA block; releases all channels
+void dma_init(void);
+
+// claims an unused DMA channel; returns the channel number or -1 if all channels are in use
+int8_t dma_channel_claim(void);
+
+// releases a claimed DMA channel; a transfer in progress is aborted, the channel is disabled and its interrupt is turned off
+void dma_channel_unclaim(uint8_t channel);
+
+// sets the completion callback of a channel and enables its interrupt on the channel's IRQ line; passing 0 disables the interrupt
+void dma_channel_set_callback(uint8_t channel, dma_callback_t callback);
+
+// selects the IRQ line (enum dma_irq_line) the completion interrupt of a channel is routed to; an enabled interrupt is moved to the new line
+void dma_channel_set_irq_line(uint8_t channel, uint8_t line);
+
+// stops the transfer of a DMA channel and waits until the channel has finished its outstanding bus transfers
+// the completion flag raised by the abort (RP2040-E13) is discarded, so the channel's callback is not called
+void dma_channel_abort(uint8_t channel);
+
+// copies len bytes from src to dest (the buffers must not overlap); the copy is finished when dma_async_busy() returns false
+void dma_memcpy_async(dma_async_t *handle, void *dest, const void *src, uint32_t len);
+
+// fills len bytes of dest with val; the fill is finished when dma_async_busy() returns false
+void dma_memset_async(dma_async_t *handle, void *dest, uint8_t val, uint32_t len);
+
+// claims the channel pair of a scatter-gather transfer; returns false if there are not enough free channels
+bool dma_sg_claim(dma_sg_t *sg);
+
+// releases the channel pair of a scatter-gather transfer
+void dma_sg_unclaim(dma_sg_t *sg);
+
+// starts the transfer of a descriptor list terminated by dma_sg_end(); the list must stay valid until the transfer completes
+void dma_sg_start(dma_sg_t *sg, const dma_sg_descriptor_t *list);
+
+// stops a scatter-gather transfer
+void dma_sg_abort(dma_sg_t *sg);
+
+// claims the sniffer; returns false if it is in use
+bool dma_sniffer_claim(void);
+
+// releases the claimed sniffer
+void dma_sniffer_unclaim(void);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the default configuration: 32-bit transfers, both addresses incrementing, unpaced, no ring and no chaining
+static inline dma_channel_config_t dma_channel_default_config(uint8_t channel) {
+
+    return (dma_channel_config_t){
+
+        .data_size = dma_size_32,
+        .incr_read = true,
+        .incr_write = true,
+        .ring_size_bits = 0,
+        .ring_write = false,
+        .dreq = DMA_DREQ_PERMANENT,
+        .chain_to = channel,
+        .high_priority = false,
+        .bswap = false,
+        .irq_quiet = false,
+        .sniff = false
+    };
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the CTRL register value of a configuration; the channel is enabled
+static inline uint32_t dma_channel_config_ctrl(const dma_channel_config_t *config) {
+
+    return (DMA_CTRL_EN | ((uint32_t)config->data_size << DMA_CTRL_DATA_SIZE_LSB) | ((uint32_t)config->dreq << DMA_CTRL_TREQ_SEL_LSB) |
+            ((uint32_t)config->chain_to << DMA_CTRL_CHAIN_TO_LSB) | ((uint32_t)config->ring_size_bits << DMA_CTRL_RING_SIZE_LSB) |
+            (config->ring_write ? DMA_CTRL_RING_SEL : 0) | (config->incr_read ? DMA_CTRL_INCR_READ : 0) | (config->incr_write ? DMA_CTRL_INCR_WRITE : 0) |
+            (config->high_priority ? DMA_CTRL_HIGH_PRIORITY : 0) | (config->bswap ? DMA_CTRL_BSWAP : 0) | (config->irq_quiet ? DMA_CTRL_IRQ_QUIET : 0) |
+            (config->sniff ? DMA_CTRL_SNIFF_EN : 0));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// configures the DMA channel from a configuration; the channel is started immediately if start is true
+static inline void dma_channel_setup(uint8_t channel, const dma_channel_config_t *config, const volatile void *read_addr, volatile void *write_addr, uint32_t transfer_count, bool start) {
+
+    DMA->CH[channel].READ_ADDR = (uint32_t)read_addr;
+    DMA->CH[channel].WRITE_ADDR = (uint32_t)write_addr;
+    DMA->CH[channel].TRANS_COUNT = transfer_count;
+
+    if (start) DMA->CH[channel].CTRL_TRIG = dma_channel_config_ctrl(config);
+    else DMA->CH[channel].AL1_CTRL = dma_channel_config_ctrl(config);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// configures the DMA channel without starting it; chaining is disabled (CHAIN_TO is set to the channel itself)
+static inline void dma_channel_configure(uint8_t channel, const volatile void *read_addr, volatile void *write_addr, uint32_t transfer_count, uint32_t ctrl) {
+
+    DMA->CH[channel].READ_ADDR = (uint32_t)read_addr;
+    DMA->CH[channel].WRITE_ADDR = (uint32_t)write_addr;
+    DMA->CH[channel].TRANS_COUNT = transfer_count;
+    DMA->CH[channel].AL1_CTRL = (ctrl & ~DMA_CTRL_CHAIN_TO_MASK) | (channel << DMA_CTRL_CHAIN_TO_LSB);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// makes the channel trigger another channel when it completes; chaining a channel to itself disables chaining
+static inline void dma_channel_chain_to(uint8_t channel, uint8_t chain_to) {
+
+    atomic_write_masked(DMA->CH[channel].AL1_CTRL, chain_to, DMA_CTRL_CHAIN_TO_MASK, DMA_CTRL_CHAIN_TO_LSB);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts a configured DMA channel
+static inline void dma_channel_start(uint8_t channel) {
+
+    DMA->MULTI_CHAN_TRIGGER = (1 << channel);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts a new transfer from the specified address; the write address and control register keep their previous values
+static inline void dma_channel_transfer_from(uint8_t channel, const volatile void *read_addr, uint32_t transfer_count) {
+
+    DMA->CH[channel].READ_ADDR = (uint32_t)read_addr;
+    DMA->CH[channel].AL1_TRANS_COUNT_TRIG = transfer_count;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts a new transfer to the specified address; the read address and control register keep their previous values
+static inline void dma_channel_transfer_to(uint8_t channel, volatile void *write_addr, uint32_t transfer_count) {
+
+    DMA->CH[channel].WRITE_ADDR = (uint32_t)write_addr;
+    DMA->CH[channel].AL1_TRANS_COUNT_TRIG = transfer_count;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true if the DMA channel is transferring data
+static inline bool dma_channel_busy(uint8_t channel) {
+
+    return (bit_is_set(DMA->CH[channel].AL1_CTRL, DMA_CTRL_BUSY));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// waits until the DMA channel finishes its transfer
+static inline void dma_channel_wait(uint8_t channel) {
+
+    while (dma_channel_busy(channel));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the number of transfers the channel has left in its current transfer sequence
+static inline uint32_t dma_channel_remaining(uint8_t channel) {
+
+    return (DMA->CH[channel].TRANS_COUNT);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true if the channel received a bus error; the error flags are cleared
+static inline bool dma_channel_check_error(uint8_t channel) {
+
+    uint32_t ctrl = DMA->CH[channel].AL1_CTRL;
+    if (bit_is_clear(ctrl, DMA_CTRL_AHB_ERROR)) return false;
+
+    atomic_set_bits(DMA->CH[channel].AL1_CTRL, ctrl & (DMA_CTRL_READ_ERROR | DMA_CTRL_WRITE_ERROR));     // write one to clear
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// fills a scatter-gather descriptor; the chaining and IRQ_QUIET of the configuration are overridden to continue the list
+static inline void dma_sg_set(dma_sg_descriptor_t *descriptor, dma_sg_t *sg, const dma_channel_config_t *config, const volatile void *read_addr, volatile void *write_addr, uint32_t transfer_count) {
+
+    descriptor->ctrl = (dma_channel_config_ctrl(config) & ~DMA_CTRL_CHAIN_TO_MASK) | (sg->control_channel << DMA_CTRL_CHAIN_TO_LSB) | DMA_CTRL_IRQ_QUIET;
+    descriptor->write_addr = write_addr;
+    descriptor->transfer_count = transfer_count;
+    descriptor->read_addr = read_addr;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// fills the null descriptor terminating a list; the data channel stops and raises its interrupt (the callback of the data channel is called)
+static inline void dma_sg_end(dma_sg_descriptor_t *descriptor, dma_sg_t *sg) {
+
+    descriptor->ctrl = DMA_CTRL_EN | DMA_CTRL_IRQ_QUIET | (DMA_DREQ_PERMANENT << DMA_CTRL_TREQ_SEL_LSB) | (sg->data_channel << DMA_CTRL_CHAIN_TO_LSB);
+    descriptor->write_addr = 0;
+    descriptor->transfer_count = 0;
+    descriptor->read_addr = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true while a scatter-gather transfer is in progress
+static inline bool dma_sg_busy(dma_sg_t *sg) {
+
+    return (dma_channel_busy(sg->control_channel) || dma_channel_busy(sg->data_channel));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts the sniffer on the transfers of a channel; mode is a DMA_SNIFF_CTRL_CALC_VAL_x value with the OUT_INV, OUT_REV and BSWAP flags
+static inline void dma_sniffer_enable(uint8_t channel, uint32_t mode, uint32_t seed) {
+
+    DMA->SNIFF_DATA = seed;
+    DMA->SNIFF_CTRL = mode | (channel << DMA_SNIFF_CTRL_DMACH_LSB) | DMA_SNIFF_CTRL_EN;
+    atomic_set_bits(DMA->CH[channel].AL1_CTRL, DMA_CTRL_SNIFF_EN);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// stops the sniffer; the result stays in the data register
+static inline void dma_sniffer_disable(uint8_t channel) {
+
+    atomic_clear_bits(DMA->CH[channel].AL1_CTRL, DMA_CTRL_SNIFF_EN);
+    DMA->SNIFF_CTRL = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the sniffer result, transformed by the OUT_INV and OUT_REV flags
+static inline uint32_t dma_sniffer_get_data(void) {
+
+    return (DMA->SNIFF_DATA);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true while an asynchronous memory operation is in progress
+static inline bool dma_async_busy(dma_async_t *handle) {
+
+    return (handle->busy);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// sleeps (WFE) until an asynchronous memory operation completes; the completion interrupt signals SEV, so the waiting core may be either core
+static inline void dma_async_wait(dma_async_t *handle) {
+
+    while (handle->busy) __WFE();
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_DMA_H_ */
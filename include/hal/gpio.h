@@ -83,7 +83,7 @@ static inline void gpio_init() {
 // sets GPIO function
 static inline void gpio_set_function(uint8_t gpio, enum gpio_func function) {
 
-    write_masked(IO_BANK0->GPIO[gpio].CTRL, function, IO_BANK0_GPIO_CTRL_FUNCSEL_MASK, IO_BANK0_GPIO_CTRL_FUNCSEL_LSB);
+    atomic_write_masked(IO_BANK0->GPIO[gpio].CTRL, function, IO_BANK0_GPIO_CTRL_FUNCSEL_MASK, IO_BANK0_GPIO_CTRL_FUNCSEL_LSB);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -93,8 +93,8 @@ static inline void gpio_set_dir(uint8_t gpio, enum gpio_dir dir) {
 
     gpio_set_function(gpio, GPIO_FUNC_SIO);
 
-    if (dir == GPIO_DIR_OUTPUT) set_bits(SIO->GPIO_OE_SET, (1 << gpio));
-    else set_bits(SIO->GPIO_OE_CLR, (1 << gpio));
+    if (dir == GPIO_DIR_OUTPUT) SIO->GPIO_OE_SET = (1 << gpio);
+    else SIO->GPIO_OE_CLR = (1 << gpio);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -102,7 +102,7 @@ static inline void gpio_set_dir(uint8_t gpio, enum gpio_dir dir) {
 // sets GPIO pullup/pulldown registor
 static inline void gpio_set_pull(uint8_t gpio, enum gpio_pull pull) {
 
-    write_masked(PADS_BANK0->GPIO[gpio], pull, (PADS_BANK0_GPIO_PUE | PADS_BANK0_GPIO_PDE), 2);
+    atomic_write_masked(PADS_BANK0->GPIO[gpio], pull, (PADS_BANK0_GPIO_PUE | PADS_BANK0_GPIO_PDE), 2);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -110,8 +110,8 @@ static inline void gpio_set_pull(uint8_t gpio, enum gpio_pull pull) {
 // sets GPIO output to HIGH or LOW
 static inline void gpio_write(uint8_t gpio, bool state) {
 
-    if (state) set_bits(SIO->GPIO_OUT_SET, (1 << gpio));
-    else set_bits(SIO->GPIO_OUT_CLR, (1 << gpio));
+    if (state) SIO->GPIO_OUT_SET = (1 << gpio);
+    else SIO->GPIO_OUT_CLR = (1 << gpio);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -119,7 +119,7 @@ static inline void gpio_write(uint8_t gpio, bool state) {
 // toggles GPIO output
 static inline void gpio_toggle(uint8_t gpio) {
 
-    set_bits(SIO->GPIO_OUT_XOR, (1 << gpio));
+    SIO->GPIO_OUT_XOR = (1 << gpio);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -147,12 +147,12 @@ static inline void gpio_set_irq(uint8_t gpio, enum gpio_irq_event_t events, bool
 
         gpio_acknowledge_irq(gpio);
 
-        set_bits(IO_BANK0->PROC0.INTE[gpio / 8], events << ((gpio % 8) * 4));
+        atomic_set_bits(IO_BANK0->PROC0.INTE[gpio / 8], events << ((gpio % 8) * 4));
         NVIC_EnableIRQ(IO_BANK0_IRQ);
 
     } else {
 
-        clear_bits(IO_BANK0->PROC0.INTE[gpio / 8], events << ((gpio % 8) * 4));
+        atomic_clear_bits(IO_BANK0->PROC0.INTE[gpio / 8], events << ((gpio % 8) * 4));
     }  
 }
 
@@ -4,19 +4,95 @@
 /*
  *  RP2040 I2C LL Driver
  *  Martin Kopka 2024
+ *
+ *  Transactions (write, read or write followed by a repeated start read) are queued with i2c_submit() and executed
+ *  from the I2C IRQ handler, which keeps the 16-entry TX FIFO filled with commands; the caller polls the status or gets a callback.
+ *  The blocking i2c_start_transmission() / i2c_write() functions must not be used while queued transactions are in progress.
+ *
+ *  With i2c_enable_dma(), reads of up to I2C_DMA_MAX_READ bytes (optionally preceded by a write of up to 16 bytes) are executed by two DMA
+ *  channels paced by the I2C DREQs: one feeds the read commands to DATA_CMD, the other one moves the received bytes to the buffer.
+ *  The CPU is involved only when the transaction starts and once more when the stop condition is detected.
 */
 
 #include "rp2040.h"
 #include "hal/timer.h"
 
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define I2C_DMA_MAX_READ    64      // maximum number of bytes of a read executed by the DMA; longer reads are interrupt driven
+
+#ifndef I2C_DFS_TIMEOUT_US
+#define I2C_DFS_TIMEOUT_US  10000   // time a clock change waits for the transaction in progress; then the transaction is aborted [us]
+#endif
+
+#ifndef I2C_ABORT_TIMEOUT_US
+#define I2C_ABORT_TIMEOUT_US 1000   // time an abort waits for the hardware to generate the stop condition [us]
+#endif
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+enum i2c_status {
+
+    i2c_idle    = 0x00,     // not submitted yet
+    i2c_queued  = 0x01,     // waiting for the previous transactions to complete
+    i2c_busy    = 0x02,     // being transferred
+    i2c_done    = 0x03,     // completed successfully
+    i2c_aborted = 0x04      // aborted by the hardware; the cause is stored in abort_source
+};
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+struct i2c_transaction;
+// transaction completion callback; called from the I2C IRQ handler (or from the context aborting the transaction), the transaction can be resubmitted from the callback
+// transaction completion callback; called from the I2C IRQ handler, the transaction can be resubmitted from the callback
+typedef void (*i2c_callback_t)(struct i2c_transaction *transaction);
+
+// I2C transaction; provided by the caller and must stay valid until it completes
+typedef struct i2c_transaction {
+
+    uint8_t        address;         // 7-bit address of the slave
+    const uint8_t *tx_data;         // bytes to be written; not used if tx_len is 0
+    uint16_t       tx_len;          // number of bytes to be written; 0 for a read-only transaction
+    uint8_t       *rx_data;         // buffer for the bytes read after the write (with a repeated start); not used if rx_len is 0
+    uint16_t       rx_len;          // number of bytes to be read; 0 for a write-only transaction
+    i2c_callback_t callback;        // called when the transaction completes; may be 0
+    void          *context;         // user data for the callback
+
+    volatile enum i2c_status status;    // state of the transaction
+    volatile uint32_t abort_source;     // content of the TX_ABRT_SOURCE register if the transaction was aborted
+
+    // internal state of the driver
+    uint16_t cmd_index;                 // number of commands written to the TX FIFO
+    uint16_t rx_index;                  // number of bytes read from the RX FIFO
+    struct i2c_transaction *next;       // next transaction in the queue
+
+} i2c_transaction_t;
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the I2C hardware
+// initializes the I2C hardware; an instance that is already initialized is deinitialized first
 void i2c_init(I2C_t *i2c, uint32_t baudrate, uint8_t sda_pin, uint8_t scl_pin);
 
-// deinitializes the I2C hardware
+// sets the baud rate according to the current clk_sys frequency; called automatically when the DFS service changes the clocks
+void i2c_set_baudrate(I2C_t *i2c, uint32_t baudrate);
+
+// deinitializes the I2C hardware; queued transactions are completed as aborted and their callbacks are called from the calling context
 void i2c_deinit(I2C_t *i2c);
 
+// switches reads to DMA mode; the DMA needs to be initialized first. Returns false if there are not two DMA channels available
+bool i2c_enable_dma(I2C_t *i2c);
+
+// queues a transaction; it starts immediately if the bus is idle. Returns false if the I2C is not initialized, the transaction is empty or already queued
+bool i2c_submit(I2C_t *i2c, i2c_transaction_t *transaction);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the transaction has completed, successfully or not
+static inline bool i2c_transaction_complete(i2c_transaction_t *transaction) {
+
+    return (transaction->status == i2c_done || transaction->status == i2c_aborted);
+}
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 // starts the I2C transmission by transmitting the restart sequence
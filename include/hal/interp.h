@@ -0,0 +1,100 @@
+#ifndef _HAL_INTERP_H_
+#define _HAL_INTERP_H_
+
+/*
+ *  RP2040 SIO Interpolator LL Driver
+ *  Martin Kopka 2024
+ *
+ *  Each core has two interpolators (INTERP0 and INTERP1) in its SIO; the SIO register block always maps the interpolators of the calling core.
+ *  Each lane shifts its accumulator right, masks a range of bits and adds its base in a single cycle; POP additionally writes the lane results
+ *  back to the accumulators, so stepping through tables and coordinates costs one load per element.
+ *
+ *  The kernels below reconfigure INTERP0 (and INTERP1 for the clamping kernel). An IRQ handler using an interpolator that may be in use
+ *  by the interrupted code has to save its state with interp_save() and restore it with interp_restore() before returning.
+*/
+
+#include "rp2040.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define INTERP0 (&SIO->INTERP[0])       // interpolator 0 of the calling core; supports the blend mode
+#define INTERP1 (&SIO->INTERP[1])       // interpolator 1 of the calling core; supports the clamp mode
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+// complete state of an interpolator
+typedef struct {
+
+    uint32_t accum[2];
+    uint32_t base[3];
+    uint32_t ctrl[2];
+
+} interp_state_t;
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// maps each sample through a table of 16-bit entries: output = table[(input >> index_lsb) & ((1 << index_bits) - 1)]
+void interp_lut_u16(const uint16_t *input, uint16_t *output, uint32_t len, const uint16_t *table, uint8_t index_lsb, uint8_t index_bits);
+
+// blends two signed 16-bit signals: output = a + (b - a) * alpha / 256
+void interp_blend_s16(const int16_t *a, const int16_t *b, int16_t *output, uint32_t len, uint8_t alpha);
+
+// resamples a signed 16-bit signal with linear interpolation; position and step are 16.16 fixed point sample indices.
+// The source must contain the sample following the last position read. Returns the position following the last output sample
+uint32_t interp_resample_s16(const int16_t *input, int16_t *output, uint32_t len, uint32_t position, uint32_t step);
+
+// scales signed fixed-point samples by an arithmetic right shift and saturates the result: output = clamp(input >> shift, min, max)
+void interp_scale_s32(const int32_t *input, int32_t *output, uint32_t len, uint8_t shift, int32_t min, int32_t max);
+
+// samples a texture of 8-bit texels (2^width_bits x 2^height_bits, row major) along a span; u, v, du and dv are 16.16 fixed point
+// texel coordinates, the coordinates wrap around the texture edges
+void interp_texture_span_u8(const uint8_t *texture, uint8_t width_bits, uint8_t height_bits, uint32_t u, uint32_t v, int32_t du, int32_t dv, uint8_t *output, uint32_t len);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+/** configures a lane of the interpolator
+ * @param interp INTERP0 or INTERP1
+ * @param lane 0 or 1
+ * @param shift right shift applied to the accumulator (0 - 31)
+ * @param mask_lsb, mask_msb the range of bits kept after the shift (inclusive)
+ * @param flags combination of SIO_INTERP_CTRL_LANE_SIGNED, _CROSS_INPUT, _CROSS_RESULT, _ADD_RAW, _BLEND, _CLAMP
+*/
+static inline void interp_lane_configure(SIO_INTERP_t *interp, uint8_t lane, uint8_t shift, uint8_t mask_lsb, uint8_t mask_msb, uint32_t flags) {
+
+    uint32_t ctrl = flags | (shift << SIO_INTERP_CTRL_LANE_SHIFT_LSB) | (mask_lsb << SIO_INTERP_CTRL_LANE_MASK_LSB_LSB) | (mask_msb << SIO_INTERP_CTRL_LANE_MASK_MSB_LSB);
+
+    if (lane == 0) interp->CTRL_LANE0 = ctrl;
+    else           interp->CTRL_LANE1 = ctrl;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// saves the complete state of the interpolator
+static inline void interp_save(SIO_INTERP_t *interp, interp_state_t *state) {
+
+    state->accum[0] = interp->ACCUM0;
+    state->accum[1] = interp->ACCUM1;
+    state->base[0] = interp->BASE0;
+    state->base[1] = interp->BASE1;
+    state->base[2] = interp->BASE2;
+    state->ctrl[0] = interp->CTRL_LANE0;
+    state->ctrl[1] = interp->CTRL_LANE1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// restores the state saved by interp_save()
+static inline void interp_restore(SIO_INTERP_t *interp, const interp_state_t *state) {
+
+    interp->ACCUM0 = state->accum[0];
+    interp->ACCUM1 = state->accum[1];
+    interp->BASE0 = state->base[0];
+    interp->BASE1 = state->base[1];
+    interp->BASE2 = state->base[2];
+    interp->CTRL_LANE0 = state->ctrl[0];
+    interp->CTRL_LANE1 = state->ctrl[1];
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_INTERP_H_ */
@@ -0,0 +1,136 @@
+#ifndef _HAL_MULTICORE_H_
+#define _HAL_MULTICORE_H_
+
+/*
+ *  RP2040 Multicore LL Driver
+ *  Martin Kopka 2024
+ *
+ *  Core 1 is held by the bootrom after reset, waiting for a launch sequence from core 0 on the inter-core FIFO.
+ *  multicore_launch_core1() resets core 1 and passes it the vector table, the initial stack pointer and the entry point.
+ *  By default the core 1 stack occupies SRAM4 and the core 0 stack SRAM5, so the stacks don't contend with the striped main memory.
+ *
+ *  The inter-core FIFOs are 8 words deep in each direction. The blocking functions sleep with WFE and every FIFO access is followed
+ *  by SEV, so a core waiting on the other one is woken up as soon as the FIFO state changes. Alternatively, the received words
+ *  can be delivered to a callback from the SIO_PROC interrupt of the receiving core.
+*/
+
+#include "rp2040.h"
+#include "registers/address_map.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define MULTICORE_FIFO_DEPTH        8                       // depth of each inter-core FIFO [words]
+#define MULTICORE_CORE1_STACK_TOP   ((uint32_t*)SRAM5_BASE) // default core 1 stack (SRAM4, grows down from its end)
+
+//---- TYPES -----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// FIFO receive callback; called from the SIO_PROC IRQ handler of the receiving core for every received word
+typedef void (*multicore_fifo_callback_t)(uint32_t data);
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// resets core 1 and starts it at the entry function with the stack in SRAM4; must be called from core 0. Core 1 sleeps if the entry function returns
+void multicore_launch_core1(void (*entry)(void));
+
+// resets core 1 and starts it at the entry function with the specified stack; stack_top is the address just above the stack (8-byte aligned)
+void multicore_launch_core1_with_stack(void (*entry)(void), uint32_t *stack_top);
+
+// holds core 1 in reset; it can be started again by multicore_launch_core1()
+void multicore_reset_core1(void);
+
+// sets the callback for the words received by the calling core and enables its SIO_PROC interrupt; passing 0 disables the interrupt
+void multicore_fifo_set_callback(multicore_fifo_callback_t callback);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the number of the core executing the code (0 or 1)
+static inline uint8_t multicore_get_core_num(void) {
+
+    return (SIO->CPUID);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if there is a word in the RX FIFO of the calling core
+static inline bool multicore_fifo_rx_valid(void) {
+
+    return (bit_is_set(SIO->FIFO_ST, SIO_FIFO_ST_VLD));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the TX FIFO of the calling core can accept a word
+static inline bool multicore_fifo_tx_ready(void) {
+
+    return (bit_is_set(SIO->FIFO_ST, SIO_FIFO_ST_RDY));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sends a word to the other core; returns false if the FIFO is full
+static inline bool multicore_fifo_try_push(uint32_t data) {
+
+    if (!multicore_fifo_tx_ready()) return false;
+
+    SIO->FIFO_WR = data;
+    __SEV();            // wake up the other core if it is waiting for data
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// receives a word from the other core; returns false if the FIFO is empty
+static inline bool multicore_fifo_try_pop(uint32_t *data) {
+
+    if (!multicore_fifo_rx_valid()) return false;
+
+    *data = SIO->FIFO_RD;
+    __SEV();            // wake up the other core if it is waiting for space
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sends a word to the other core; sleeps while the FIFO is full
+static inline void multicore_fifo_push_blocking(uint32_t data) {
+
+    while (!multicore_fifo_tx_ready()) __WFE();
+
+    SIO->FIFO_WR = data;
+    __SEV();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// receives a word from the other core; sleeps while the FIFO is empty
+static inline uint32_t multicore_fifo_pop_blocking(void) {
+
+    while (!multicore_fifo_rx_valid()) __WFE();
+
+    uint32_t data = SIO->FIFO_RD;
+    __SEV();
+
+    return data;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// discards all words in the RX FIFO of the calling core
+static inline void multicore_fifo_drain(void) {
+
+    while (multicore_fifo_rx_valid()) (void)SIO->FIFO_RD;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// clears the sticky overflow (WOF) and underflow (ROE) flags of the calling core, which also clears their interrupt
+static inline void multicore_fifo_clear_errors(void) {
+
+    SIO->FIFO_ST = SIO_FIFO_ST_WOF | SIO_FIFO_ST_ROE;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_MULTICORE_H_ */
@@ -9,17 +9,53 @@
 #include "rp2040.h"
 #include "hal/resets.h"
 
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define PLL_VCO_MIN_HZ      750000000       // minimum VCO frequency
+#define PLL_VCO_MAX_HZ      1600000000      // maximum VCO frequency
+#define PLL_FBDIV_MIN       16              // minimum feedback divider
+#define PLL_FBDIV_MAX       320             // maximum feedback divider
+#define PLL_POSTDIV_MAX     7               // maximum value of each post divider
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+// PLL settings; f_out = f_ref * fbdiv / (postdiv1 * postdiv2), the reference divider is always 1
+typedef struct {
+
+    uint16_t fbdiv;         // VCO feedback divider; f_ref * fbdiv must be within the VCO range
+    uint8_t  postdiv1;      // first post divider (1 - 7)
+    uint8_t  postdiv2;      // second post divider (1 - 7)
+
+} pll_config_t;
+
+//---- PRESETS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+// PLL settings for a 12 MHz crystal, resolved at compile time; all of them are exact
+#define PLL_CONFIG_12MHZ_TO_48MHZ       ((pll_config_t){.fbdiv =  64, .postdiv1 = 4, .postdiv2 = 4})     // VCO  768 MHz; USB PLL
+#define PLL_CONFIG_12MHZ_TO_100MHZ      ((pll_config_t){.fbdiv = 100, .postdiv1 = 6, .postdiv2 = 2})     // VCO 1200 MHz
+#define PLL_CONFIG_12MHZ_TO_125MHZ      ((pll_config_t){.fbdiv = 125, .postdiv1 = 6, .postdiv2 = 2})     // VCO 1500 MHz
+#define PLL_CONFIG_12MHZ_TO_133MHZ      ((pll_config_t){.fbdiv = 133, .postdiv1 = 6, .postdiv2 = 2})     // VCO 1596 MHz
+#define PLL_CONFIG_12MHZ_TO_200MHZ      ((pll_config_t){.fbdiv = 100, .postdiv1 = 6, .postdiv2 = 1})     // VCO 1200 MHz
+#define PLL_CONFIG_12MHZ_TO_250MHZ      ((pll_config_t){.fbdiv = 125, .postdiv1 = 6, .postdiv2 = 1})     // VCO 1500 MHz
+
+// output frequency of the PLL settings [Hz]
+#define pll_config_hz(ref_hz, config) ((uint32_t)(((uint64_t)(ref_hz) * (config).fbdiv) / ((config).postdiv1 * (config).postdiv2)))
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
 // initializes the pll block
 void pll_init(PLL_t *pll, uint16_t vco_fdiv, uint8_t post_div1, uint8_t post_div2);
 
+// finds the PLL settings producing the frequency closest to target_hz (the lowest VCO frequency among equally close settings, to save power);
+// does not access the hardware. Returns false if no settings within the VCO range exist
+bool pll_plan(uint32_t ref_hz, uint32_t target_hz, pll_config_t *config);
+
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 // disables the pll block
 static inline void pll_disable(PLL_t *pll) {
 
-    set_bits(pll->PWR, PLL_PWR_PD);
+    atomic_set_bits(pll->PWR, PLL_PWR_PD);
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
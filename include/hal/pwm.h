@@ -8,7 +8,7 @@
 
 #include "rp2040.h"
 #include "hal/resets.h"
-#include "hal/fc0.h"
+#include "hal/clocks.h"
 
 //---- ENUMERATONS -----------------------------------------------------------------------------------------------------------------------------------------------
 
@@ -50,10 +50,10 @@ static inline void pwm_set_enable(uint8_t slice, bool enabled) {
 
     if (enabled) {
         
-        set_bits(PWM->CH[slice].CSR, PWM_CSR_EN);
+        atomic_set_bits(PWM->CH[slice].CSR, PWM_CSR_EN);
         PWM->CH[slice].CTR = 0;
 
-    } else clear_bits(PWM->CH[slice].CSR, PWM_CSR_EN);
+    } else atomic_clear_bits(PWM->CH[slice].CSR, PWM_CSR_EN);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -77,7 +77,7 @@ static inline void pwm_set_wrap(uint8_t slice, uint16_t wrap) {
 // sets the duty cycle of the specified PWM slice and channel
 static inline void pwm_set_duty(uint8_t slice, enum pwm_channel channel, uint16_t duty) {
 
-    write_masked(PWM->CH[slice].CC, duty, 0xffff << (channel * 16), channel * 16);
+    atomic_write_masked(PWM->CH[slice].CC, duty, 0xffff << (channel * 16), channel * 16);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -101,7 +101,7 @@ static inline void pwm_set_resolution(uint8_t slice, uint8_t resolution) {
 // calculates the clock divider value according to the specified PWM frequency (note: resolution must be set first)
 static inline void pwm_set_frequency(uint8_t slice, uint32_t frequency_hz) {
 
-    PWM->CH[slice].DIV = (16 * fc0_get_hz(fc0_clk_sys)) / (frequency_hz * (PWM->CH[slice].TOP + 1));
+    PWM->CH[slice].DIV = (16 * clocks_get_hz(clk_sys)) / (frequency_hz * (PWM->CH[slice].TOP + 1));
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
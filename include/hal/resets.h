@@ -23,7 +23,7 @@
 // restets specified hardware block (or multiple blocks)
 static inline void resets_reset_block(uint32_t block) {
 
-    set_bits(RESETS->RESET, block);
+    atomic_set_bits(RESETS->RESET, block);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -31,7 +31,7 @@ static inline void resets_reset_block(uint32_t block) {
 // brings specified hardware block (or multiple blocks) out of reset
 static inline void resets_unreset_block(uint32_t block) {
 
-    clear_bits(RESETS->RESET, block);
+    atomic_clear_bits(RESETS->RESET, block);
 
 	// wait for the reset to become deasserted
     while (bit_is_clear(RESETS->RESET_DONE, block));
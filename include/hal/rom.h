@@ -0,0 +1,108 @@
+#ifndef _HAL_ROM_H_
+#define _HAL_ROM_H_
+
+/*
+ *  RP2040 Bootrom functions
+ *  Martin Kopka 2024
+ *
+ *  The bootrom exports its functions and data through tables of two-character codes; the table pointers and the lookup function
+ *  are stored as 16-bit addresses at the start of the ROM. rom_init() (called by the startup code before main) resolves the
+ *  functions used by the HAL once and caches them in rom_table, so calling a ROM function costs one load and an indirect branch.
+ *
+ *  With ROM_FLOAT set, the single precision soft-float helpers of the compiler (__aeabi_fadd, fsub, fmul, fdiv and the int
+ *  conversions) are routed to the ROM floating point library, which is several times faster than libgcc.
+*/
+
+#include "rp2040.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef ROM_FLOAT
+#define ROM_FLOAT 0     // route the compiler's single precision float helpers to the ROM
+#endif
+
+#define ROM_TABLE_CODE(c1, c2) ((c1) | ((c2) << 8))     // code of a ROM function or data entry
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+// ROM soft-float library; the entries follow the order of the ROM table ('SF' data entry)
+typedef struct {
+
+    float    (*fadd)(float a, float b);
+    float    (*fsub)(float a, float b);
+    float    (*fmul)(float a, float b);
+    float    (*fdiv)(float a, float b);
+    int      (*fcmp_fast)(float a, float b);
+    int      (*fcmp_fast_flags)(float a, float b);
+    float    (*fsqrt)(float a);
+    int32_t  (*float2int)(float a);
+    int32_t  (*float2fix)(float a, int32_t fbits);
+    uint32_t (*float2uint)(float a);
+    uint32_t (*float2ufix)(float a, int32_t fbits);
+    float    (*int2float)(int32_t a);
+    float    (*fix2float)(int32_t a, int32_t fbits);
+    float    (*uint2float)(uint32_t a);
+    float    (*ufix2float)(uint32_t a, int32_t fbits);
+    float    (*fcos)(float a);
+    float    (*fsin)(float a);
+    float    (*ftan)(float a);
+    void     *_reserved;
+    float    (*fexp)(float a);
+    float    (*fln)(float a);
+
+} rom_float_table_t;
+
+// ROM functions resolved by rom_init()
+typedef struct {
+
+    uint32_t (*popcount32)(uint32_t value);
+    uint32_t (*reverse32)(uint32_t value);
+    uint32_t (*clz32)(uint32_t value);
+    uint32_t (*ctz32)(uint32_t value);
+    uint8_t *(*memset)(uint8_t *ptr, uint8_t value, uint32_t len);
+    uint32_t *(*memset4)(uint32_t *ptr, uint8_t value, uint32_t len);
+    uint8_t *(*memcpy)(uint8_t *dest, const uint8_t *src, uint32_t len);
+    void *(*memcpy44)(uint32_t *dest, const uint32_t *src, uint32_t len);
+
+    const rom_float_table_t *soft_float;
+
+} rom_table_t;
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// resolves the ROM functions into rom_table; called by the startup code before main
+void rom_init(void);
+
+// returns the address of the ROM function with the code or 0 if the ROM does not provide it
+void *rom_func_lookup(uint32_t code);
+
+// returns the address of the ROM data with the code or 0 if the ROM does not provide it
+void *rom_data_lookup(uint32_t code);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+extern rom_table_t rom_table;       // cached ROM functions
+
+// returns the version of the bootrom (1 for the B0 chips, 2 for B1, 3 for B2)
+static inline uint8_t rom_get_version(void) {
+
+    return (*(const uint8_t*)(ROM_BASE + 0x13));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the number of set bits
+static inline uint32_t rom_popcount32(uint32_t value) {return rom_table.popcount32(value);}
+
+// returns the value with the bit order reversed
+static inline uint32_t rom_reverse32(uint32_t value) {return rom_table.reverse32(value);}
+
+// returns the number of leading zeros; 32 for 0
+static inline uint32_t rom_clz32(uint32_t value) {return rom_table.clz32(value);}
+
+// returns the number of trailing zeros; 32 for 0
+static inline uint32_t rom_ctz32(uint32_t value) {return rom_table.ctz32(value);}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_ROM_H_ */
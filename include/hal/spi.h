@@ -4,16 +4,59 @@
 /*
  *  RP2040 SPI LL Driver
  *  Martin Kopka 2024
+ *
+ *  In DMA mode the transfers run entirely in hardware: a TX and an RX channel are paced by the SSP DREQs and the frame size follows
+ *  the data width passed to spi_init() (uint8_t buffers up to 8 bits, uint16_t buffers otherwise).
+ *  Streaming alternates between two buffers; the application refills one buffer while the other one is being clocked out.
+ *  With chaining enabled, a second TX channel is triggered by the first one in hardware, so there is no gap between the buffers.
+ *  Chained buffers of a power-of-two size (at most 32 kB) aligned to their size are rearmed by the read ring of the DMA; other buffers are
+ *  rearmed by the DMA IRQ, and a stream whose IRQ is late by a whole buffer is stopped instead of sending the memory behind the buffer.
 */
 
 #include "rp2040.h"
 #include "hal/gpio.h"
 
+//---- TYPES -----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// DMA completion callback; called from the DMA IRQ handler with the index of the buffer that has been sent (always 0 for single transfers)
+typedef void (*spi_callback_t)(SPI_t *spi, uint8_t buffer);
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the SPI block
+// initializes the SPI block; an SPI that is already initialized is deinitialized first
 void spi_init(SPI_t *spi, uint32_t baudrate_hz, uint8_t data_width);
 
+// deinitializes the SPI block; a DMA transfer or stream in progress is aborted without calling its callback and the DMA channels are released
+void spi_deinit(SPI_t *spi);
+
+// sets the baud rate according to the current clk_peri frequency; called automatically when the DFS service changes the clocks
+void spi_set_baudrate(SPI_t *spi, uint32_t baudrate_hz);
+
+// transmits len frames from tx and stores the len received frames to rx while keeping the TX FIFO filled, so the frames are sent back to back;
+// the buffers are uint8_t arrays for data widths up to 8 bits and uint16_t arrays otherwise. tx may be 0 to transmit zeros, rx may be 0 to discard the received data
+void spi_transfer(SPI_t *spi, const void *tx, void *rx, uint32_t len);
+
+// transmits len frames from tx back to back and discards the received data; the buffer is a uint8_t array for data widths up to 8 bits and a uint16_t array otherwise
+static inline void spi_write_buffer(SPI_t *spi, const void *tx, uint32_t len) {spi_transfer(spi, tx, 0, len);}
+
+// switches the SPI to DMA mode; the DMA needs to be initialized first. Returns false if there are not two DMA channels available
+bool spi_enable_dma(SPI_t *spi);
+
+// starts a DMA transfer of len frames; tx may be 0 to transmit zeros, rx may be 0 to discard the received data. The callback (may be 0) is called
+// when the last frame has been received. Returns false if the DMA mode is not enabled or the DMA is busy
+bool spi_transfer_dma(SPI_t *spi, const void *tx, void *rx, uint32_t len, spi_callback_t callback);
+
+// returns true while a DMA transfer or a stream is in progress
+bool spi_dma_busy(SPI_t *spi);
+
+// starts streaming two buffers of len frames alternately until spi_stream_stop() is called; the callback is called whenever a buffer has been sent
+// and can be refilled. With chained set, the buffers follow each other without a gap (needs one more DMA channel); otherwise the next buffer is started
+// from the DMA IRQ. Received data is discarded. Returns false if the DMA mode is not enabled, the DMA is busy or no DMA channel is available
+bool spi_stream_start(SPI_t *spi, const void *buffer_0, const void *buffer_1, uint32_t len, bool chained, spi_callback_t callback);
+
+// stops streaming; the frame being sent is finished
+void spi_stream_stop(SPI_t *spi);
+
 // reads the SPI RX data buffer
 static inline uint16_t spi_read(SPI_t *spi) {return (spi->SSPDR);}
 
@@ -0,0 +1,151 @@
+#ifndef _HAL_SPINLOCK_H_
+#define _HAL_SPINLOCK_H_
+
+/*
+ *  RP2040 Hardware spinlock LL Driver
+ *  Martin Kopka 2024
+ *
+ *  The SIO provides 32 hardware spinlocks shared by both cores. Reading a lock claims it and returns nonzero if it was free,
+ *  writing any value releases it. The first locks are assigned to the HAL drivers, the rest can be claimed at runtime.
+ *  The _irqsave variants also mask the interrupts of the calling core, so a lock taken by the main loop can't be requested again
+ *  by an IRQ on the same core; the plain variants are meant for IRQ handlers and for code that never shares the lock with an IRQ.
+ *
+ *  Each lock counts its acquisitions and the acquisitions that found the lock taken (SPINLOCK_STATS), to show which locks are hot.
+ *  The counters are updated while the lock is held, so they are consistent across the cores.
+*/
+
+#include "rp2040.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define SPINLOCK_COUNT      32      // number of hardware spinlocks
+
+#ifndef SPINLOCK_STATS
+#define SPINLOCK_STATS      1       // count the acquisitions and contentions of the locks
+#endif
+
+//---- ENUMERATIONS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// spinlocks assigned to the HAL drivers
+enum spinlock_id {
+
+    spinlock_id_claim       = 0x00,     // spinlock allocator
+    spinlock_id_dma         = 0x01,     // DMA channel allocator
+    spinlock_id_uart0_tx    = 0x02,     // UART0 TX fifo producers
+    spinlock_id_uart1_tx    = 0x03,     // UART1 TX fifo producers
+    spinlock_id_uart0_rx    = 0x04,     // UART0 RX fifo consumers
+    spinlock_id_uart1_rx    = 0x05,     // UART1 RX fifo consumers
+    spinlock_id_i2c0        = 0x06,     // I2C0 transaction queue
+    spinlock_id_i2c1        = 0x07,     // I2C1 transaction queue
+    spinlock_id_soft_timer  = 0x08,     // software timer heap
+
+    spinlock_id_first_free  = 0x09      // first lock available to spinlock_claim()
+};
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+typedef struct {
+
+    uint32_t acquired;      // number of acquisitions
+    uint32_t contended;     // number of acquisitions that had to wait for the other owner
+
+} spinlock_stats_t;
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// claims an unused spinlock; returns the lock number or -1 if all locks are in use
+int8_t spinlock_claim(void);
+
+// releases a claimed spinlock
+void spinlock_unclaim(uint8_t lock);
+
+// returns the acquisition counters of the lock
+spinlock_stats_t spinlock_get_stats(uint8_t lock);
+
+// resets the acquisition counters of all locks
+void spinlock_reset_stats(void);
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+#if SPINLOCK_STATS
+extern spinlock_stats_t spinlock_stats[SPINLOCK_COUNT];    // acquisition counters; written only by the owner of the lock
+#endif
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// acquires the lock; spins while the lock is owned by someone else
+static force_inline void spinlock_lock(uint8_t lock) {
+
+    if (SIO->SPINLOCK[lock] == 0) {
+
+        while (SIO->SPINLOCK[lock] == 0);
+
+#if SPINLOCK_STATS
+        spinlock_stats[lock].contended++;
+#endif
+    }
+
+    __DMB();        // the protected data is accessed only after the lock has been acquired
+
+#if SPINLOCK_STATS
+    spinlock_stats[lock].acquired++;
+#endif
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// releases the lock
+static force_inline void spinlock_unlock(uint8_t lock) {
+
+    __DMB();        // the protected data is written before the lock is released
+    SIO->SPINLOCK[lock] = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// tries to acquire the lock without spinning; returns true if the lock has been acquired
+static force_inline bool spinlock_try_lock(uint8_t lock) {
+
+    if (SIO->SPINLOCK[lock] == 0) return false;
+
+    __DMB();
+
+#if SPINLOCK_STATS
+    spinlock_stats[lock].acquired++;
+#endif
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// masks the interrupts of the calling core and acquires the lock; returns the previous interrupt state for spinlock_unlock_irqrestore()
+static force_inline uint32_t spinlock_lock_irqsave(uint8_t lock) {
+
+    uint32_t primask = __get_PRIMASK();
+    __disable_irq();
+    spinlock_lock(lock);
+
+    return primask;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// releases the lock and restores the interrupt state saved by spinlock_lock_irqsave()
+static force_inline void spinlock_unlock_irqrestore(uint8_t lock, uint32_t primask) {
+
+    spinlock_unlock(lock);
+    __set_PRIMASK(primask);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the lock is currently owned
+static inline bool spinlock_is_locked(uint8_t lock) {
+
+    return (bit_is_set(SIO->SPINLOCK_ST, (1 << lock)));
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _HAL_SPINLOCK_H_ */
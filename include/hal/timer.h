@@ -4,12 +4,62 @@
 /*
  *  RP2040 ADC Timer Driver
  *  Martin Kopka 2024
+ *
+ *  Software timers: any number of one-shot and periodic timers (up to SOFT_TIMER_MAX armed at once) share hardware alarm 0.
+ *  The armed timers are kept in a binary min-heap ordered by deadline and ALARM0 is always programmed to the earliest one,
+ *  so starting and cancelling a timer costs O(log n). The alarm IRQ expires at most SOFT_TIMER_MAX_EXPIRIES timers per
+ *  invocation, which bounds its run time; the rest is handled by an immediate re-entry of the IRQ.
+ *  The timers may be started and cancelled from the main loop, from their callbacks, from IRQs and from both cores; the heap is protected
+ *  by a hardware spinlock. The callbacks run on the core that called soft_timer_init().
 */
 
 #include "rp2040.h"
 
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef SOFT_TIMER_MAX
+#define SOFT_TIMER_MAX              32      // maximum number of software timers armed at once
+#endif
+
+#ifndef SOFT_TIMER_MAX_EXPIRIES
+#define SOFT_TIMER_MAX_EXPIRIES     8       // maximum number of timers expired in one invocation of the alarm IRQ
+#endif
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+struct soft_timer;
+
+// timer expiry callback; called from the TIMER_IRQ0 handler
+typedef void (*soft_timer_callback_t)(struct soft_timer *timer);
+
+// software timer; provided by the caller and must stay valid while it is armed
+typedef struct soft_timer {
+
+    uint64_t              deadline;     // time of the next expiry [us]
+    uint32_t              period;       // period of a periodic timer [us]; 0 for a one-shot timer
+    soft_timer_callback_t callback;     // called when the timer expires
+    void                 *context;      // user data for the callback
+    uint16_t              heap_slot;    // position in the heap of armed timers + 1; 0 if the timer is not armed (a zeroed timer is valid)
+
+} soft_timer_t;
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
+// initializes the software timer service on alarm 0; Watchdog tick needs to be initialized first
+void soft_timer_init(void);
+
+// arms the timer to expire after delay_us and then every period_us (0 for a one-shot timer); an armed timer is restarted.
+// Returns false if SOFT_TIMER_MAX timers are armed already
+bool soft_timer_start(soft_timer_t *timer, uint32_t delay_us, uint32_t period_us, soft_timer_callback_t callback);
+
+// disarms the timer; does nothing if the timer is not armed
+void soft_timer_cancel(soft_timer_t *timer);
+
+// returns true if the timer is armed
+static inline bool soft_timer_is_active(soft_timer_t *timer) {return (timer->heap_slot != 0);}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
 // returns the time since reset [us]; Watchdog tick needs to be initialized first
 static inline uint64_t timer_get_us(void) {
 
@@ -5,39 +5,71 @@
  *  RP2040 UART hardware abstraction layer
  *  Martin Kopka 2024
  *
- *  Implements software FIFOs (circular buffers) for:
+ *  Implements software FIFOs (lock-free SPSC ring buffers, see utils/ring.h) for:
  *  • data to be transmitted by the hardware
  *  • received data not yet read by the software
+ *
+ *  The buffer sizes must be powers of two. Each UART allows a single writer context, which may run on either core, i.e. uart_putc()
+ *  must not be called from an IRQ and from the main loop at the same time; the writer pushes to the TX fifo without locking. The hardware
+ *  side of the TX fifo and the readers of the RX fifo are serialized by per-instance hardware spinlocks (see hal/spinlock.h), so data
+ *  can be read from the main loop, from IRQs and from both cores
 */ 
 
 #include "rp2040.h"
 
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#ifndef UART_RX_IDLE_CHARS
+#define UART_RX_IDLE_CHARS  16      // number of character times without received data after which the RX DMA hands the receiver back to the RX interrupts
+#endif
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the UART hardware
-void uart_init(UART_t *uart, uint32_t baudrate, uint8_t tx_gpio, uint8_t rx_gpio, char *tx_buffer, uint32_t tx_buffer_size, char *rx_buffer, uint32_t rx_buffer_size);
+// initializes the UART hardware; the buffer sizes must be powers of two. Returns false if no buffer is provided or a buffer size is not a power of two
+bool uart_init(UART_t *uart, uint32_t baudrate, uint8_t tx_gpio, uint8_t rx_gpio, char *tx_buffer, uint32_t tx_buffer_size, char *rx_buffer, uint32_t rx_buffer_size);
 
 // deinitializes the UART hardware
 void uart_deinit(UART_t *uart);
 
+// sets the baud rate according to the current clk_peri frequency; called automatically when the DFS service changes the clocks
+void uart_set_baudrate(UART_t *uart, uint32_t baudrate);
+
+// switches the transmitter to DMA mode; the DMA needs to be initialized first. Returns false if no DMA channel is available
+bool uart_enable_tx_dma(UART_t *uart);
+
+// switches the receiver to DMA mode; the first bytes of a burst raise the RX interrupt, which hands the receiver to the DMA until the line has been idle for
+// UART_RX_IDLE_CHARS character times (measured by a soft timer). The RX buffer size must be a power of two and the buffer aligned to its size; the DMA needs
+// to be initialized first. Without the soft timer service the DMA keeps the receiver and data is published when polled. Returns false if the buffer is not
+// suitable or no DMA channel is available
+bool uart_enable_rx_dma(UART_t *uart);
+
+// returns the number of received bytes that were lost because the RX buffer was full
+uint32_t uart_get_rx_overruns(UART_t *uart);
+
 // returns true, if the RX buffer contains new data
 bool uart_has_data(UART_t *uart);
 
 // flushes the RX buffer
 void uart_flush(UART_t *uart);
 
-// transmits one byte via UART; waits if the TX fifo is full
+// transmits one byte via UART; skips the byte if the TX fifo is full
 void uart_putc(UART_t *uart, char c);
 
 // converts a number to string and sends it via UART
 void uart_puti(UART_t *uart, int num);
 
-// transmits a null-terminated string via UART; waits if the TX fifo is full
+// transmits a null-terminated string via UART; the part of the string that does not fit into the TX fifo is skipped
 void uart_puts(UART_t *uart, const char *str);
 
+// copies up to len bytes to the TX fifo and starts the transmission; returns the number of bytes accepted (the rest did not fit into the fifo)
+uint32_t uart_write(UART_t *uart, const void *data, uint32_t len);
+
 // reads one byte from the RX buffer; returns -1 if there is no new data
 int16_t uart_getc(UART_t *uart);
 
+// copies up to len bytes from the RX buffer; returns the number of bytes read
+uint32_t uart_read(UART_t *uart, void *data, uint32_t len);
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #endif /* _HAL_UART_H_ */
\ No newline at end of file
@@ -21,7 +21,7 @@ static inline void xosc_enable(void) {
     XOSC->STARTUP = XOSC_STARTUP_DELAY;                 // set XOSC startup delay
 
 	// enable XOSC
-    write_masked(XOSC->CTRL, XOSC_CTRL_ENABLE_VALUE_ENABLE, XOSC_CTRL_ENABLE_MASK, XOSC_CTRL_ENABLE_LSB);
+    atomic_write_masked(XOSC->CTRL, XOSC_CTRL_ENABLE_VALUE_ENABLE, XOSC_CTRL_ENABLE_MASK, XOSC_CTRL_ENABLE_LSB);
 	
     // wait for XOSC to become stable
     while (bit_is_clear(XOSC->STATUS, XOSC_STATUS_STABLE));
@@ -33,7 +33,7 @@ static inline void xosc_enable(void) {
 static inline void xosc_disable(void) {
 
     // disable XOSC
-    write_masked(XOSC->CTRL, XOSC_CTRL_ENABLE_VALUE_DISABLE, XOSC_CTRL_ENABLE_MASK, XOSC_CTRL_ENABLE_LSB);
+    atomic_write_masked(XOSC->CTRL, XOSC_CTRL_ENABLE_VALUE_DISABLE, XOSC_CTRL_ENABLE_MASK, XOSC_CTRL_ENABLE_LSB);
 
     // wait for XOSC to become unstable
     while (bit_is_set(XOSC->STATUS, XOSC_STATUS_STABLE));
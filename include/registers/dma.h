@@ -0,0 +1,227 @@
+#ifndef _REG_DMA_H_
+#define _REG_DMA_H_
+
+/*
+ *  RP2040 DMA register definitions
+ *  Martin Kopka 2024
+ *
+ *  The RP2040 Direct Memory Access (DMA) master performs bulk data transfers on a processor’s behalf.
+ *  This leaves processors free to attend to other tasks, or enter low-power sleep states.
+ *  • 12 independent channels, each with its own read address, write address, transfer count and control register
+ *  • Transfers are paced by a data request (DREQ) from a peripheral, by one of four pacing timers or run unpaced
+ *  • Channels can be chained, so that the completion of one channel triggers another
+*/
+
+#include "registers/address_map.h"
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define DMA_CHANNEL_COUNT 12        // number of DMA channels
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// each channel exposes its four control registers in four different orders (aliases); the last register of each alias is a trigger
+typedef struct {
+
+    reg_t READ_ADDR;               // DMA Channel Read Address pointer
+    reg_t WRITE_ADDR;              // DMA Channel Write Address pointer
+    reg_t TRANS_COUNT;             // DMA Channel Transfer Count
+    reg_t CTRL_TRIG;               // DMA Channel Control and Status (trigger)
+    reg_t AL1_CTRL;                // Alias for channel CTRL register
+    reg_t AL1_READ_ADDR;           // Alias for channel READ_ADDR register
+    reg_t AL1_WRITE_ADDR;          // Alias for channel WRITE_ADDR register
+    reg_t AL1_TRANS_COUNT_TRIG;    // Alias for channel TRANS_COUNT register (trigger)
+    reg_t AL2_CTRL;                // Alias for channel CTRL register
+    reg_t AL2_TRANS_COUNT;         // Alias for channel TRANS_COUNT register
+    reg_t AL2_READ_ADDR;           // Alias for channel READ_ADDR register
+    reg_t AL2_WRITE_ADDR_TRIG;     // Alias for channel WRITE_ADDR register (trigger)
+    reg_t AL3_CTRL;                // Alias for channel CTRL register
+    reg_t AL3_WRITE_ADDR;          // Alias for channel WRITE_ADDR register
+    reg_t AL3_TRANS_COUNT;         // Alias for channel TRANS_COUNT register
+    reg_t AL3_READ_ADDR_TRIG;      // Alias for channel READ_ADDR register (trigger)
+
+} DMA_CH_t;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// debug registers of a single channel
+typedef struct {
+
+    reg_t CTDREQ;                  // Read: get channel DREQ counter (i.e. how many accesses the DMA expects it can perform on the peripheral without overflow/underflow. Write any value: clears the counter, and cause channel to re-initiate DREQ handshake.
+    reg_t TCR;                     // Read to get channel TRANS_COUNT reload value, i.e. the length of the next transfer
+    uint32_t _RESERVED_0[14];
+
+} DMA_CH_DBG_t;
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+typedef struct {
+
+    DMA_CH_t CH[DMA_CHANNEL_COUNT];                             // channel registers
+    uint32_t _RESERVED_0[64];
+    reg_t INTR;                    // Interrupt Status (raw)
+    reg_t INTE0;                   // Interrupt Enables for IRQ 0
+    reg_t INTF0;                   // Force Interrupts
+    reg_t INTS0;                   // Interrupt Status for IRQ 0
+    uint32_t _RESERVED_1;
+    reg_t INTE1;                   // Interrupt Enables for IRQ 1
+    reg_t INTF1;                   // Force Interrupts for IRQ 1
+    reg_t INTS1;                   // Interrupt Status (masked) for IRQ 1
+    reg_t PACING_TIMER[4];         // Pacing (X/Y) Fractional Timer. The pacing timer produces TREQ assertions at a rate set by ((X/Y) * sys_clk).
+    reg_t MULTI_CHAN_TRIGGER;      // Trigger one or more channels simultaneously
+    reg_t SNIFF_CTRL;              // Sniffer Control
+    reg_t SNIFF_DATA;              // Data accumulator for sniff hardware
+    uint32_t _RESERVED_2;
+    reg_t FIFO_LEVELS;             // Debug RAF, WAF, TDF levels
+    reg_t CHAN_ABORT;              // Abort an in-progress transfer sequence on one or more channels
+    reg_t N_CHANNELS;              // The number of channels this DMA instance is equipped with
+    uint32_t _RESERVED_3[237];
+    DMA_CH_DBG_t CH_DBG[DMA_CHANNEL_COUNT];                     // channel debug registers
+
+} DMA_t;
+
+#define DMA ((DMA_t*)DMA_BASE)       // DMA register block
+
+//==== REGISTER BIT DEFINITIONS ==================================================================================================================================
+
+// DMA: CTRL register
+// DMA Channel Control and Status
+
+#define DMA_CTRL_AHB_ERROR          _BIT(31)    // Logical OR of the READ_ERROR and WRITE_ERROR flags
+#define DMA_CTRL_READ_ERROR         _BIT(30)    // If 1, the channel received a read bus error. Write one to clear.
+#define DMA_CTRL_WRITE_ERROR        _BIT(29)    // If 1, the channel received a write bus error. Write one to clear.
+#define DMA_CTRL_BUSY               _BIT(24)    // This flag goes high when the channel starts a new transfer sequence, and low when the last transfer of that sequence completes.
+#define DMA_CTRL_SNIFF_EN           _BIT(23)    // If 1, this channel’s data transfers are visible to the sniff hardware, and each transfer will advance the state of the checksum.
+#define DMA_CTRL_BSWAP              _BIT(22)    // Apply byte-swap transformation to DMA data.
+#define DMA_CTRL_IRQ_QUIET          _BIT(21)    // In QUIET mode, the channel does not generate IRQs at the end of every transfer block. Instead, an IRQ is raised when NULL is written to a trigger register, indicating the end of a control block chain.
+
+// Select a Transfer Request signal. The channel uses the transfer request signal to pace its data transfer rate.
+#define DMA_CTRL_TREQ_SEL_LSB       15
+#define DMA_CTRL_TREQ_SEL_MASK      0x001f8000
+
+// When this channel completes, it will trigger the channel indicated by CHAIN_TO. Disable by setting CHAIN_TO = (this channel).
+#define DMA_CTRL_CHAIN_TO_LSB       11
+#define DMA_CTRL_CHAIN_TO_MASK      0x00007800
+
+#define DMA_CTRL_RING_SEL           _BIT(10)    // Select whether RING_SIZE applies to read or write addresses. If 0, read addresses are wrapped on a (1 << RING_SIZE) boundary. If 1, write addresses are wrapped.
+
+// Size of address wrap region. If 0, don’t wrap. For values n > 0, only the lower n bits of the address will change.
+#define DMA_CTRL_RING_SIZE_LSB      6
+#define DMA_CTRL_RING_SIZE_MASK     0x000003c0
+
+#define DMA_CTRL_INCR_WRITE         _BIT(5)     // If 1, the write address increments with each transfer. If 0, each write is directed to the same, initial address.
+#define DMA_CTRL_INCR_READ          _BIT(4)     // If 1, the read address increments with each transfer. If 0, each read is directed to the same, initial address.
+
+// Set the size of each bus transfer (byte/halfword/word). READ_ADDR and WRITE_ADDR advance by this amount (1/2/4 bytes) with each transfer.
+#define DMA_CTRL_DATA_SIZE_LSB              2
+#define DMA_CTRL_DATA_SIZE_MASK             0x0000000c
+#define DMA_CTRL_DATA_SIZE_VAL_BYTE         (0x0 << DMA_CTRL_DATA_SIZE_LSB)
+#define DMA_CTRL_DATA_SIZE_VAL_HALFWORD     (0x1 << DMA_CTRL_DATA_SIZE_LSB)
+#define DMA_CTRL_DATA_SIZE_VAL_WORD         (0x2 << DMA_CTRL_DATA_SIZE_LSB)
+
+#define DMA_CTRL_HIGH_PRIORITY      _BIT(1)     // HIGH_PRIORITY gives a channel preferential treatment in issue scheduling: in each scheduling round, all high priority channels are considered first, and then only a single low priority channel, before returning to the high priority channels.
+#define DMA_CTRL_EN                 _BIT(0)     // DMA Channel Enable. When 1, the channel will respond to triggering events, which will cause it to become BUSY and start transferring data. When 0, the channel will ignore triggers, stop issuing transfers, and pause the current transfer sequence (i.e. BUSY will remain high if already high)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// DMA: TREQ_SEL values
+// Transfer request signals (DREQs) of the peripherals
+
+#define DMA_DREQ_PIO0_TX0           0x00
+#define DMA_DREQ_PIO0_TX1           0x01
+#define DMA_DREQ_PIO0_TX2           0x02
+#define DMA_DREQ_PIO0_TX3           0x03
+#define DMA_DREQ_PIO0_RX0           0x04
+#define DMA_DREQ_PIO0_RX1           0x05
+#define DMA_DREQ_PIO0_RX2           0x06
+#define DMA_DREQ_PIO0_RX3           0x07
+#define DMA_DREQ_PIO1_TX0           0x08
+#define DMA_DREQ_PIO1_TX1           0x09
+#define DMA_DREQ_PIO1_TX2           0x0a
+#define DMA_DREQ_PIO1_TX3           0x0b
+#define DMA_DREQ_PIO1_RX0           0x0c
+#define DMA_DREQ_PIO1_RX1           0x0d
+#define DMA_DREQ_PIO1_RX2           0x0e
+#define DMA_DREQ_PIO1_RX3           0x0f
+#define DMA_DREQ_SPI0_TX            0x10
+#define DMA_DREQ_SPI0_RX            0x11
+#define DMA_DREQ_SPI1_TX            0x12
+#define DMA_DREQ_SPI1_RX            0x13
+#define DMA_DREQ_UART0_TX           0x14
+#define DMA_DREQ_UART0_RX           0x15
+#define DMA_DREQ_UART1_TX           0x16
+#define DMA_DREQ_UART1_RX           0x17
+#define DMA_DREQ_PWM_WRAP0          0x18
+#define DMA_DREQ_PWM_WRAP1          0x19
+#define DMA_DREQ_PWM_WRAP2          0x1a
+#define DMA_DREQ_PWM_WRAP3          0x1b
+#define DMA_DREQ_PWM_WRAP4          0x1c
+#define DMA_DREQ_PWM_WRAP5          0x1d
+#define DMA_DREQ_PWM_WRAP6          0x1e
+#define DMA_DREQ_PWM_WRAP7          0x1f
+#define DMA_DREQ_I2C0_TX            0x20
+#define DMA_DREQ_I2C0_RX            0x21
+#define DMA_DREQ_I2C1_TX            0x22
+#define DMA_DREQ_I2C1_RX            0x23
+#define DMA_DREQ_ADC                0x24
+#define DMA_DREQ_XIP_STREAM         0x25
+#define DMA_DREQ_XIP_SSITX          0x26
+#define DMA_DREQ_XIP_SSIRX          0x27
+#define DMA_DREQ_TIMER0             0x3b        // Select Timer 0 as TREQ
+#define DMA_DREQ_TIMER1             0x3c        // Select Timer 1 as TREQ
+#define DMA_DREQ_TIMER2             0x3d        // Select Timer 2 as TREQ (Optional)
+#define DMA_DREQ_TIMER3             0x3e        // Select Timer 3 as TREQ (Optional)
+#define DMA_DREQ_PERMANENT          0x3f        // Permanent request, for unlimited unpaced transfers.
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// DMA: PACING_TIMERx register
+// Pacing (X/Y) Fractional Timer
+
+// Pacing Timer Dividend. Specifies the X value for the (X/Y) fractional timer.
+#define DMA_TIMER_X_LSB             16
+#define DMA_TIMER_X_MASK            0xffff0000
+
+// Pacing Timer Divisor. Specifies the Y value for the (X/Y) fractional timer.
+#define DMA_TIMER_Y_LSB             0
+#define DMA_TIMER_Y_MASK            0x0000ffff
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// DMA: SNIFF_CTRL register
+// Sniffer Control
+
+#define DMA_SNIFF_CTRL_OUT_INV      _BIT(11)    // If set, the result appears inverted (bitwise complement) when read. This does not affect the way the checksum is calculated; the result is transformed on-the-fly between the result register and the bus.
+#define DMA_SNIFF_CTRL_OUT_REV      _BIT(10)    // If set, the result appears bit-reversed when read. This does not affect the way the checksum is calculated; the result is transformed on-the-fly between the result register and the bus.
+#define DMA_SNIFF_CTRL_BSWAP        _BIT( 9)    // Locally perform a byte reverse on the sniffed data, before feeding into checksum.
+
+#define DMA_SNIFF_CTRL_CALC_LSB             5
+#define DMA_SNIFF_CTRL_CALC_MASK            0x000001e0
+#define DMA_SNIFF_CTRL_CALC_VAL_CRC32       (0x0 << DMA_SNIFF_CTRL_CALC_LSB)    // Calculate a CRC-32 (IEEE802.3 polynomial)
+#define DMA_SNIFF_CTRL_CALC_VAL_CRC32R      (0x1 << DMA_SNIFF_CTRL_CALC_LSB)    // Calculate a CRC-32 (IEEE802.3 polynomial) with bit reversed data
+#define DMA_SNIFF_CTRL_CALC_VAL_CRC16       (0x2 << DMA_SNIFF_CTRL_CALC_LSB)    // Calculate a CRC-16-CCITT
+#define DMA_SNIFF_CTRL_CALC_VAL_CRC16R      (0x3 << DMA_SNIFF_CTRL_CALC_LSB)    // Calculate a CRC-16-CCITT with bit reversed data
+#define DMA_SNIFF_CTRL_CALC_VAL_EVEN        (0xe << DMA_SNIFF_CTRL_CALC_LSB)    // XOR reduction over all data. == 1 if the total 1 population count is odd.
+#define DMA_SNIFF_CTRL_CALC_VAL_SUM         (0xf << DMA_SNIFF_CTRL_CALC_LSB)    // Calculate a simple 32-bit checksum (addition with a 32 bit accumulator)
+
+// DMA channel for Sniffer to observe
+#define DMA_SNIFF_CTRL_DMACH_LSB    1
+#define DMA_SNIFF_CTRL_DMACH_MASK   0x0000001e
+
+#define DMA_SNIFF_CTRL_EN           _BIT( 0)    // Enable sniffer
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// DMA: FIFO_LEVELS register
+// Debug RAF, WAF, TDF levels
+
+#define DMA_FIFO_LEVELS_RAF_LVL_LSB     16      // Current Read-Address-FIFO fill level
+#define DMA_FIFO_LEVELS_RAF_LVL_MASK    0x00ff0000
+#define DMA_FIFO_LEVELS_WAF_LVL_LSB     8       // Current Write-Address-FIFO fill level
+#define DMA_FIFO_LEVELS_WAF_LVL_MASK    0x0000ff00
+#define DMA_FIFO_LEVELS_TDF_LVL_LSB     0       // Current Transfer-Data-FIFO fill level
+#define DMA_FIFO_LEVELS_TDF_LVL_MASK    0x000000ff
+
+//================================================================================================================================================================
+
+#endif /* _REG_DMA_H_ */
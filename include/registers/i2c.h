@@ -154,6 +154,40 @@ typedef struct {
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
+// I2C: TX_ABRT_SOURCE register
+// I2C Transmit Abort Source Register
+
+#define I2C_TX_ABRT_SOURCE_TX_FLUSH_CNT_LSB     23
+#define I2C_TX_ABRT_SOURCE_TX_FLUSH_CNT_MASK    0xff800000
+
+#define I2C_TX_ABRT_SOURCE_ABRT_USER_ABRT       _BIT(16)
+#define I2C_TX_ABRT_SOURCE_ABRT_SLVRD_INTX      _BIT(15)
+#define I2C_TX_ABRT_SOURCE_ABRT_SLV_ARBLOST     _BIT(14)
+#define I2C_TX_ABRT_SOURCE_ABRT_SLVFLUSH_TXFIFO _BIT(13)
+#define I2C_TX_ABRT_SOURCE_ARB_LOST             _BIT(12)
+#define I2C_TX_ABRT_SOURCE_ABRT_MASTER_DIS      _BIT(11)
+#define I2C_TX_ABRT_SOURCE_ABRT_10B_RD_NORSTRT  _BIT(10)
+#define I2C_TX_ABRT_SOURCE_ABRT_SBYTE_NORSTRT   _BIT(9)
+#define I2C_TX_ABRT_SOURCE_ABRT_HS_NORSTRT      _BIT(8)
+#define I2C_TX_ABRT_SOURCE_ABRT_SBYTE_ACKDET    _BIT(7)
+#define I2C_TX_ABRT_SOURCE_ABRT_HS_ACKDET       _BIT(6)
+#define I2C_TX_ABRT_SOURCE_ABRT_GCALL_READ      _BIT(5)
+#define I2C_TX_ABRT_SOURCE_ABRT_GCALL_NOACK     _BIT(4)
+#define I2C_TX_ABRT_SOURCE_ABRT_TXDATA_NOACK    _BIT(3)
+#define I2C_TX_ABRT_SOURCE_ABRT_10ADDR2_NOACK   _BIT(2)
+#define I2C_TX_ABRT_SOURCE_ABRT_10ADDR1_NOACK   _BIT(1)
+#define I2C_TX_ABRT_SOURCE_ABRT_7B_ADDR_NOACK   _BIT(0)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// I2C: DMA_CR register
+// DMA Control Register
+
+#define I2C_DMA_CR_TDMAE    _BIT(1)
+#define I2C_DMA_CR_RDMAE    _BIT(0)
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
 // TODO: SDA_HOLD and the rest
 
 //================================================================================================================================================================
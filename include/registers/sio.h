@@ -103,7 +103,8 @@ typedef struct {
 #define SIO_INTERP_CTRL_LANE_OVERF              _BIT(25)
 #define SIO_INTERP_CTRL_LANE_OVERF1             _BIT(24)
 #define SIO_INTERP_CTRL_LANE_OVERF0             _BIT(23)
-#define SIO_INTERP_CTRL_LANE_BLEND              _BIT(21)
+#define SIO_INTERP_CTRL_LANE_CLAMP              _BIT(22)    // INTERP1 lane 0 only: the result is clamped to BASE0 ... BASE1
+#define SIO_INTERP_CTRL_LANE_BLEND              _BIT(21)    // INTERP0 lane 0 only: lane 1 blends BASE0 and BASE1 by the 8 LSBs of its own shift and mask value
 
 #define SIO_INTERP_CTRL_LANE_FORCE_MSB_LSB      19
 #define SIO_INTERP_CTRL_LANE_FORCE_MSB_MASK     0x00180000
@@ -109,6 +109,14 @@ typedef struct {
 #define SPI_SSPICR_RTIC     _BIT(1)
 #define SPI_SSPICR_RORIC    _BIT(0)
 
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+// SPI: SSPDMACR register
+// DMA control register
+
+#define SPI_SSPDMACR_TXDMAE     _BIT(1)
+#define SPI_SSPDMACR_RXDMAE     _BIT(0)
+
 //================================================================================================================================================================
 
 #endif /* _REG_SPI_H_ */
\ No newline at end of file
@@ -126,6 +126,13 @@ typedef struct {
 #define UART_IFLS_TXIFLSEL_LSB      0
 #define UART_IFLS_TXIFLSEL_MASK     0x00000007
 
+// FIFO level values for both fields; the RX interrupt asserts when the RX FIFO becomes >= the level, the TX interrupt asserts when the TX FIFO becomes <= the level
+#define UART_IFLS_VAL_1_8           0x0     // FIFO 1/8 full (4 bytes)
+#define UART_IFLS_VAL_1_4           0x1     // FIFO 1/4 full (8 bytes)
+#define UART_IFLS_VAL_1_2           0x2     // FIFO 1/2 full (16 bytes)
+#define UART_IFLS_VAL_3_4           0x3     // FIFO 3/4 full (24 bytes)
+#define UART_IFLS_VAL_7_8           0x4     // FIFO 7/8 full (28 bytes)
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 // UART: IMSC register
@@ -12,13 +12,13 @@
 
 typedef struct {
 
-    reg_t VREG;         // Voltage regulator control and status
+    reg_t CTRL;         // Voltage regulator control and status (VREG); renamed to avoid a clash with the VREG register block macro
     reg_t BOD;          // Brown-out detection control
     reg_t CHIP_RESET;   // Chip reset control and status
 
 } VREG_t;
 
-#define VREG ((RESETS_t*)VREG_AND_CHIP_RESET_BASES_BASE)       // VREG_AND_CHIP_RESET register block
+#define VREG ((VREG_t*)VREG_AND_CHIP_RESET_BASE)       // VREG_AND_CHIP_RESET register block
 
 //==== REGISTER BIT DEFINITIONS ==================================================================================================================================
 
@@ -86,7 +86,7 @@ typedef struct {
 #define VREG_BOD_VSEL_VAL_0V516 (VREG_BOD_VSEL0)
 #define VREG_BOD_VSEL_VAL_0V559 (VREG_BOD_VSEL1)
 #define VREG_BOD_VSEL_VAL_0V602 (VREG_BOD_VSEL1 | VREG_BOD_VSEL0)
-#define VREG_BOD_VSEL_VAL_0V645 (VREG_BOD_VSEL2 | )
+#define VREG_BOD_VSEL_VAL_0V645 (VREG_BOD_VSEL2)
 #define VREG_BOD_VSEL_VAL_0V688 (VREG_BOD_VSEL2 | VREG_BOD_VSEL0)
 #define VREG_BOD_VSEL_VAL_0V731 (VREG_BOD_VSEL2 | VREG_BOD_VSEL1)
 #define VREG_BOD_VSEL_VAL_0V774 (VREG_BOD_VSEL2 | VREG_BOD_VSEL1 | VREG_BOD_VSEL0)
@@ -94,7 +94,7 @@ typedef struct {
 #define VREG_BOD_VSEL_VAL_0V860 (VREG_BOD_VSEL3 | VREG_BOD_VSEL0)
 #define VREG_BOD_VSEL_VAL_0V903 (VREG_BOD_VSEL3 | VREG_BOD_VSEL1)
 #define VREG_BOD_VSEL_VAL_0V946 (VREG_BOD_VSEL3 | VREG_BOD_VSEL1 | VREG_BOD_VSEL0)
-#define VREG_BOD_VSEL_VAL_0V989 (VREG_BOD_VSEL3 | VREG_BOD_VSEL2 | )
+#define VREG_BOD_VSEL_VAL_0V989 (VREG_BOD_VSEL3 | VREG_BOD_VSEL2)
 #define VREG_BOD_VSEL_VAL_1V032 (VREG_BOD_VSEL3 | VREG_BOD_VSEL2 | VREG_BOD_VSEL0)
 #define VREG_BOD_VSEL_VAL_1V075 (VREG_BOD_VSEL3 | VREG_BOD_VSEL2 | VREG_BOD_VSEL1)
 #define VREG_BOD_VSEL_VAL_1V118 (VREG_BOD_VSEL3 | VREG_BOD_VSEL2 | VREG_BOD_VSEL1 | VREG_BOD_VSEL0)
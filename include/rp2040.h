@@ -12,7 +12,7 @@
 //---- REGISTER DEFINITIONS --------------------------------------------------------------------------------------------------------------------------------------
 
 #include "registers/sio.h"
-// TODO: #include "registers/dma.h"
+#include "registers/dma.h"
 #include "registers/vreg.h"
 #include "registers/psm.h"
 #include "registers/resets.h"
@@ -38,6 +38,7 @@
 
 #define __CM0PLUS_REV             0x0001        // core revision
 #define __MPU_PRESENT             1             // Memory Protection Unit present
+#define __VTOR_PRESENT            1             // Vector Table Offset Register present
 #define __NVIC_PRIO_BITS          2             // 2 NVIC priority bits
 #define __Vendor_SysTickConfig    0             // SysTick configuration
 #define __FPU_PRESENT             0             // Floating Point Unit not present
@@ -110,10 +111,47 @@ typedef enum {
 // tests if a bit is clear
 #define bit_is_clear(address, mask) (!((address) & (mask)))
 
+//---- ATOMIC REGISTER ACCESS ------------------------------------------------------------------------------------------------------------------------------------
+
+/*
+ *  Every peripheral register (except the SIO) is mirrored at three more addresses: a write to the XOR, SET or CLR alias toggles, sets or clears
+ *  the bits that are set in the written value. A single bit update is then one store instead of a read-modify-write,
+ *  which can't be corrupted by an interrupt or by the other core changing other bits of the same register.
+ *  The aliases do not exist for the SIO (it has its own SET/CLR/XOR registers) and for SRAM, use the plain functions above there.
+*/
+
+#define REG_ALIAS_XOR_OFFSET    0x1000
+#define REG_ALIAS_SET_OFFSET    0x2000
+#define REG_ALIAS_CLR_OFFSET    0x3000
+
+// accesses the alias of a peripheral register at the specified offset
+#define reg_alias(address, offset) (*(volatile uint32_t*)((uint32_t)&(address) + (offset)))
+
+// atomically sets bits in a peripheral register
+#define atomic_set_bits(address, mask) (reg_alias(address, REG_ALIAS_SET_OFFSET) = ((uint32_t)mask))
+
+// atomically clears bits in a peripheral register
+#define atomic_clear_bits(address, mask) (reg_alias(address, REG_ALIAS_CLR_OFFSET) = ((uint32_t)mask))
+
+// atomically toggles bits in a peripheral register
+#define atomic_xor_bits(address, mask) (reg_alias(address, REG_ALIAS_XOR_OFFSET) = ((uint32_t)mask))
+
+/** write bits to a group of adjacent bits in a peripheral register by toggling the bits that differ; the other bits of the register are never written
+ *  so concurrent updates of other bit groups are not lost (concurrent updates of the same group still need a lock)
+ * @param address register to manipulate
+ * @param value new value
+ * @param mask bit mask
+ * @param lsb offset to the least significant bit in a group
+*/
+#define atomic_write_masked(address, value, mask, lsb) atomic_xor_bits(address, ((address) ^ ((uint32_t)(value) << (lsb))) & (mask))
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #define force_inline inline __attribute__((always_inline))
 
+// places the function to SRAM (copied there with the .data segment), so it runs without XIP cache misses
+#define ramfunc __attribute__((section(".ramfunc"), noinline))
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
 
 #endif /* _RP2040_H_ */
@@ -0,0 +1,44 @@
+#ifndef _UTILS_CRC_H_
+#define _UTILS_CRC_H_
+
+/*
+ *  Software checksums
+ *  Martin Kopka 2024
+ *
+ *  Bitwise reference implementations of the checksums calculated by the DMA sniffer (hal/crc.h); the results are bit-exact
+ *  with the hardware, so they serve as the fallback when the sniffer is busy and as the reference on the host.
+ *
+ *  • crc32:        CRC-32 (IEEE 802.3, zlib); polynomial 0x04c11db7 reflected, seed 0xffffffff, inverted result
+ *  • crc16_ccitt:  CRC-16/CCITT-FALSE; polynomial 0x1021, seed 0xffff, not reflected
+ *  • checksum_sum: 32-bit sum of the bytes
+ *
+ *  The update functions continue a calculation over several buffers; start with the *_INIT value and finish the CRC-32 by inverting it.
+*/
+
+#include <stdint.h>
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define CRC32_INIT          0xffffffff
+#define CRC16_CCITT_INIT    0xffff
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// continues a CRC-32 calculation over len bytes; the result is not inverted
+uint32_t crc32_update(uint32_t crc, const void *data, uint32_t len);
+
+// continues a CRC-16-CCITT calculation over len bytes
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t len);
+
+// returns the CRC-32 of len bytes
+uint32_t crc32(const void *data, uint32_t len);
+
+// returns the CRC-16-CCITT of len bytes
+uint16_t crc16_ccitt(const void *data, uint32_t len);
+
+// returns the 32-bit sum of len bytes
+uint32_t checksum_sum(const void *data, uint32_t len);
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _UTILS_CRC_H_ */
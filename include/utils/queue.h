@@ -0,0 +1,156 @@
+#ifndef _UTILS_QUEUE_H_
+#define _UTILS_QUEUE_H_
+
+/*
+ *  Bounded multi-producer multi-consumer queue of 32-bit items (e.g. pointers to work items)
+ *  Martin Kopka 2024
+ *
+ *  • the queue size must be a power of two
+ *  • every slot carries a sequence number telling whether it is free for the position of a producer or filled for the position of a consumer
+ *    (D. Vyukov's bounded MPMC queue); a full or empty queue is detected from the sequence numbers without taking any lock
+ *  • the Cortex-M0+ has no exclusive load/store, so the compare-and-swap claiming a position is emulated by a hardware spinlock held
+ *    for a few instructions; the item is copied outside of the lock, so a slow producer doesn't block the others
+ *  • push and pop may be called from the main loop and from IRQs on both cores; every push and pop signals SEV,
+ *    so a consumer sleeping in queue_pop_wait() (WFE) is woken up by a producer on either core
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "hal/spinlock.h"
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+typedef struct {
+
+    volatile uint32_t sequence;     // position the slot is free for (equal) or filled for (equal - 1)
+    volatile uint32_t item;         // stored item
+
+} queue_slot_t;
+
+typedef struct {
+
+    queue_slot_t      *slots;       // slots of the queue; provided by the owner of the queue
+    uint32_t           mask;        // size of the queue - 1
+    uint8_t            lock;        // spinlock claiming the positions
+    volatile uint32_t  head;        // next position to push to
+    volatile uint32_t  tail;        // next position to pop from
+
+} queue_t;
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// initializes an empty queue and claims a spinlock for it; returns false if the size is not a power of two or no spinlock is available
+static inline bool queue_init(queue_t *queue, queue_slot_t *slots, uint32_t size) {
+
+    if (size == 0 || (size & (size - 1)) != 0) return false;
+
+    int8_t lock = spinlock_claim();
+    if (lock < 0) return false;
+
+    for (uint32_t i = 0; i < size; i++) slots[i].sequence = i;
+
+    queue->slots = slots;
+    queue->mask = size - 1;
+    queue->lock = lock;
+    queue->head = 0;
+    queue->tail = 0;
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pushes an item to the queue; returns false if the queue is full
+static inline bool queue_push(queue_t *queue, uint32_t item) {
+
+    // fast path: the slot at the head has not been released by a consumer yet, the queue is full
+    uint32_t head = queue->head;
+    if (queue->slots[head & queue->mask].sequence != head) return false;
+
+    uint32_t primask = spinlock_lock_irqsave(queue->lock);
+
+    uint32_t position = queue->head;
+    queue_slot_t *slot = &queue->slots[position & queue->mask];
+
+    // another producer may have taken the position in the meantime
+    if (slot->sequence != position) {
+
+        spinlock_unlock_irqrestore(queue->lock, primask);
+        return false;
+    }
+
+    queue->head = position + 1;
+    spinlock_unlock_irqrestore(queue->lock, primask);
+
+    slot->item = item;
+    __DMB();
+    slot->sequence = position + 1;      // publish the item
+
+    __SEV();
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pops an item from the queue; returns false if the queue is empty
+static inline bool queue_pop(queue_t *queue, uint32_t *item) {
+
+    // fast path: the slot at the tail has not been published by a producer yet, the queue is empty
+    uint32_t tail = queue->tail;
+    if (queue->slots[tail & queue->mask].sequence != tail + 1) return false;
+
+    uint32_t primask = spinlock_lock_irqsave(queue->lock);
+
+    uint32_t position = queue->tail;
+    queue_slot_t *slot = &queue->slots[position & queue->mask];
+
+    // another consumer may have taken the position in the meantime
+    if (slot->sequence != position + 1) {
+
+        spinlock_unlock_irqrestore(queue->lock, primask);
+        return false;
+    }
+
+    queue->tail = position + 1;
+    spinlock_unlock_irqrestore(queue->lock, primask);
+
+    *item = slot->item;
+    __DMB();
+    slot->sequence = position + queue->mask + 1;    // release the slot for the position one lap ahead
+
+    __SEV();
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pops an item from the queue; sleeps (WFE) while the queue is empty. A push on either core wakes the consumer up.
+// The event flag latches an SEV arriving between the check and the WFE, so no wakeup is lost
+static inline uint32_t queue_pop_wait(queue_t *queue) {
+
+    uint32_t item;
+    while (!queue_pop(queue, &item)) __WFE();
+
+    return item;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true if the queue contains no published items
+static inline bool queue_is_empty(queue_t *queue) {
+
+    uint32_t tail = queue->tail;
+    return (queue->slots[tail & queue->mask].sequence != tail + 1);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the number of items in the queue, including the items being pushed or popped at the moment
+static inline uint32_t queue_count(queue_t *queue) {
+
+    return (queue->head - queue->tail);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _UTILS_QUEUE_H_ */
@@ -0,0 +1,210 @@
+#ifndef _UTILS_RING_H_
+#define _UTILS_RING_H_
+
+/*
+ *  Lock-free single-producer single-consumer ring buffer
+ *  Martin Kopka 2024
+ *
+ *  • the buffer size must be a power of two
+ *  • head and tail are free-running counters; head is written only by the producer, tail only by the consumer
+ *  • the number of stored bytes is (head - tail), so there is no "full" flag written by both sides
+ *  • the producer and the consumer may run at different interrupt priorities without masking interrupts,
+ *    as long as there is only one producer context and one consumer context
+*/
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "utils/string.h"
+
+//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+
+typedef struct {
+
+    volatile uint8_t  *data;        // buffer to store data; provided by the owner of the ring
+             uint32_t mask;         // size of the buffer - 1
+    volatile uint32_t head;         // number of bytes ever pushed; written by the producer only
+    volatile uint32_t tail;         // number of bytes ever popped; written by the consumer only
+
+} ring_t;
+
+//---- MACROS ----------------------------------------------------------------------------------------------------------------------------------------------------
+
+// orders the data access against the index update; the Cortex-M0+ does not reorder memory accesses, so a compiler barrier is sufficient
+#define ring_barrier() __asm volatile ("" ::: "memory")
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// returns true if the size can be used for a ring buffer (a non-zero power of two)
+static inline bool ring_size_is_valid(uint32_t size) {
+
+    return (size != 0 && (size & (size - 1)) == 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// initializes the ring with an empty buffer; returns false if the size is not a power of two
+static inline bool ring_init(ring_t *ring, void *buffer, uint32_t size) {
+
+    if (!ring_size_is_valid(size)) return false;
+
+    ring->data = buffer;
+    ring->mask = size - 1;
+    ring->head = 0;
+    ring->tail = 0;
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the size of the ring buffer
+static inline uint32_t ring_size(ring_t *ring) {
+
+    return (ring->mask + 1);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the number of bytes stored in the ring
+static inline uint32_t ring_count(ring_t *ring) {
+
+    return (ring->head - ring->tail);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the number of bytes that can be pushed to the ring
+static inline uint32_t ring_free(ring_t *ring) {
+
+    return (ring_size(ring) - ring_count(ring));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true if the ring contains no data
+static inline bool ring_is_empty(ring_t *ring) {
+
+    return (ring->head == ring->tail);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns true if no more data can be pushed to the ring
+static inline bool ring_is_full(ring_t *ring) {
+
+    return (ring_count(ring) >= ring_size(ring));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pushes one byte to the ring; returns false if the ring is full (producer only)
+static inline bool ring_push(ring_t *ring, uint8_t data) {
+
+    uint32_t head = ring->head;
+    if (head - ring->tail > ring->mask) return false;
+
+    ring->data[head & ring->mask] = data;
+    ring_barrier();
+    ring->head = head + 1;
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pops one byte from the ring; returns false if the ring is empty (consumer only)
+static inline bool ring_pop(ring_t *ring, uint8_t *data) {
+
+    uint32_t tail = ring->tail;
+    if (ring->head == tail) return false;
+
+    *data = ring->data[tail & ring->mask];
+    ring_barrier();
+    ring->tail = tail + 1;
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pushes up to len bytes to the ring in at most two contiguous copies; returns the number of bytes pushed (producer only)
+static inline uint32_t ring_write(ring_t *ring, const void *src, uint32_t len) {
+
+    uint32_t head = ring->head;
+    uint32_t free = ring_size(ring) - (head - ring->tail);
+    if (len > free) len = free;
+    if (len == 0) return 0;
+
+    uint32_t offset = head & ring->mask;
+    uint32_t first = ring_size(ring) - offset;
+    if (first > len) first = len;
+
+    memcpy((uint8_t*)&ring->data[offset], src, first);
+    if (len > first) memcpy((uint8_t*)&ring->data[0], (const uint8_t*)src + first, len - first);
+
+    ring_barrier();
+    ring->head = head + len;
+
+    return len;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pops up to len bytes from the ring in at most two contiguous copies; returns the number of bytes popped (consumer only)
+static inline uint32_t ring_read(ring_t *ring, void *dest, uint32_t len) {
+
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    if (len > count) len = count;
+    if (len == 0) return 0;
+
+    ring_barrier();
+
+    uint32_t offset = tail & ring->mask;
+    uint32_t first = ring_size(ring) - offset;
+    if (first > len) first = len;
+
+    memcpy(dest, (uint8_t*)&ring->data[offset], first);
+    if (len > first) memcpy((uint8_t*)dest + first, (uint8_t*)&ring->data[0], len - first);
+
+    ring_barrier();
+    ring->tail = tail + len;
+
+    return len;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the number of bytes that can be read in one contiguous block starting at the tail and stores the address of the block to *block (consumer only)
+// the stored data may wrap around the end of the buffer, in which case the rest is returned by the next call after ring_skip()
+static inline uint32_t ring_peek_contiguous(ring_t *ring, volatile uint8_t **block) {
+
+    uint32_t tail = ring->tail;
+    uint32_t count = ring->head - tail;
+    uint32_t to_end = ring_size(ring) - (tail & ring->mask);
+
+    *block = &ring->data[tail & ring->mask];
+
+    return (count < to_end ? count : to_end);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// removes count bytes from the ring without reading them; count must not exceed ring_count() (consumer only)
+static inline void ring_skip(ring_t *ring, uint32_t count) {
+
+    ring_barrier();
+    ring->tail += count;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// discards all data stored in the ring (consumer only)
+static inline void ring_flush(ring_t *ring) {
+
+    ring->tail = ring->head;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
+
+#endif /* _UTILS_RING_H_ */
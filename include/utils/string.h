@@ -5,8 +5,13 @@
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
+// copies len bytes; the areas must not overlap
 void *memcpy (void *dest, const void *src, uint32_t len);
 
+// copies len bytes; the areas may overlap
+void *memmove (void *dest, const void *src, uint32_t len);
+
+// fills len bytes with the value
 void *memset (void *dest, int val, uint32_t len);
 
 // returns a length of a null-terminated string
@@ -0,0 +1,186 @@
+#include "hal/adc.h"
+#include "hal/dma.h"
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static int8_t dma_channel[2] = {-1, -1};            // DMA channels filling block 0 and block 1; -1 if not capturing
+static uint16_t *capture_block[2];                  // sample blocks of the capture
+static adc_callback_t capture_callback = 0;         // block callback of the capture
+static bool capture_ring = false;                   // the blocks are rearmed by the write ring of the DMA instead of the DMA IRQ
+static volatile bool capture_late = false;          // a block was refilled before its callback ran; in the IRQ rearm mode this stops the capture
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the write ring size of the DMA for a block (log2 of its size in bytes) if the block is a power of two of at most 32 kB aligned to its size; 0 otherwise
+static uint8_t __adc_ring_bits(uint16_t *block, uint32_t count) {
+
+    uint32_t size = count * sizeof(uint16_t);
+    if (count > 16384 || (size & (size - 1)) != 0 || ((uint32_t)block & (size - 1)) != 0) return 0;
+
+    uint8_t bits = 0;
+    while ((1UL << bits) < size) bits++;
+
+    return bits;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called from the DMA IRQ when a block has been filled; the other channel has already been started by the chain. The transfer count reloads
+// on every trigger; the write address has been wrapped back to the block by the write ring, otherwise it is rearmed here without triggering the channel
+static void __adc_block_complete(uint8_t channel) {
+
+    uint8_t buffer = (channel == dma_channel[1]);
+
+    // the other block has been filled as well and has retriggered this channel before the IRQ got here
+    if (dma_channel_busy(channel)) {
+
+        capture_late = true;
+
+        // without the write ring the channel has restarted from the end of its block and is overwriting the memory behind it
+        if (!capture_ring) {
+
+            adc_capture_stop();
+            return;
+        }
+    }
+
+    if (!capture_ring) DMA->CH[channel].WRITE_ADDR = (uint32_t)capture_block[buffer];
+
+    if (capture_callback != 0) capture_callback(capture_block[buffer], buffer);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// stops the conversions and empties the FIFO
+static void __adc_halt(void) {
+
+    atomic_clear_bits(ADC->CS, ADC_CS_START_MANY);
+    while (bit_is_clear(ADC->CS, ADC_CS_READY));
+
+    while (bit_is_clear(ADC->FCS, ADC_FCS_EMPTY)) (void)ADC->FIFO;
+    ADC->FCS = ADC_FCS_OVER | ADC_FCS_UNDER;        // write one to clear; disables the FIFO
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// sets the sample rate of the free-running mode; returns the exact sample rate [Hz]. Rates above clk_adc / 96 run the conversions back-to-back
+uint32_t adc_set_sample_rate(uint32_t sample_rate) {
+
+    uint32_t clk_adc_hz = clocks_get_hz(clk_adc);
+
+    // the sample period is (1 + INT + FRAC / 256) clk_adc cycles
+    uint64_t period = (sample_rate != 0) ? (((uint64_t)clk_adc_hz << 8) + (sample_rate >> 1)) / sample_rate : 0;
+
+    if (period <= (ADC_CONVERSION_CYCLES << 8)) {
+
+        ADC->DIV = 0;
+        return (clk_adc_hz / ADC_CONVERSION_CYCLES);
+    }
+
+    if (period > (ADC_DIV_INT_MASK | ADC_DIV_FRAC_MASK) + 256) period = (ADC_DIV_INT_MASK | ADC_DIV_FRAC_MASK) + 256;
+    ADC->DIV = (uint32_t)period - 256;
+
+    return (uint32_t)((((uint64_t)clk_adc_hz << 8) + (period >> 1)) / period);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// starts a continuous capture of the inputs in channel_mask (bit 0 = ADC0 .. bit 4 = ADC4) into two blocks of count samples each;
+// multiple inputs are sampled in round-robin order starting from the lowest one, so the samples of the inputs are interleaved in the blocks.
+// sample_rate is the total rate of all inputs. Returns false if the capture is running, the mask is empty or no DMA channels are available
+bool adc_capture_start(uint8_t channel_mask, uint32_t sample_rate, uint16_t *block_0, uint16_t *block_1, uint32_t count, adc_callback_t callback) {
+
+    channel_mask &= 0x1f;
+    if (dma_channel[0] >= 0 || channel_mask == 0 || count == 0) return false;
+
+    dma_channel[0] = dma_channel_claim();
+    dma_channel[1] = dma_channel_claim();
+
+    if (dma_channel[0] < 0 || dma_channel[1] < 0) {
+
+        if (dma_channel[0] >= 0) dma_channel_unclaim(dma_channel[0]);
+        if (dma_channel[1] >= 0) dma_channel_unclaim(dma_channel[1]);
+        dma_channel[0] = dma_channel[1] = -1;
+        return false;
+    }
+
+    capture_block[0] = block_0;
+    capture_block[1] = block_1;
+    capture_callback = callback;
+    capture_ring = (__adc_ring_bits(block_0, count) != 0 && __adc_ring_bits(block_1, count) != 0);
+    capture_late = false;
+
+    __adc_halt();
+
+    // the first conversion samples the input selected by AINSEL; round-robin continues from there
+    uint8_t first = 0;
+    while (bit_is_clear(channel_mask, (1 << first))) first++;
+
+    if (bit_is_set(channel_mask, (1 << ADC4))) atomic_set_bits(ADC->CS, ADC_CS_TS_EN);
+    atomic_write_masked(ADC->CS, first, ADC_CS_AINSEL_MASK, ADC_CS_AINSEL_LSB);
+    atomic_write_masked(ADC->CS, (channel_mask & (channel_mask - 1)) ? channel_mask : 0, ADC_CS_RROBIN_MASK, ADC_CS_RROBIN_LSB);
+
+    adc_set_sample_rate(sample_rate);
+
+    // each result raises the DREQ; the error flag is left out, so the samples are plain 12-bit values
+    ADC->FCS = ADC_FCS_EN | ADC_FCS_DREQ_EN | (1 << ADC_FCS_THRESH_LSB);
+
+    // the channels fill the blocks alternately and trigger each other when they complete
+    for (uint8_t buffer = 0; buffer < 2; buffer++) {
+
+        dma_channel_config_t config = dma_channel_default_config(dma_channel[buffer]);
+        config.data_size = dma_size_16;
+        config.incr_read = false;
+        config.dreq = DMA_DREQ_ADC;
+        config.chain_to = dma_channel[buffer ^ 1];
+        config.ring_size_bits = capture_ring ? __adc_ring_bits(capture_block[buffer], count) : 0;
+        config.ring_write = true;
+
+        dma_channel_setup(dma_channel[buffer], &config, &ADC->FIFO, capture_block[buffer], count, false);
+        dma_channel_set_callback(dma_channel[buffer], __adc_block_complete);
+    }
+
+    dma_channel_start(dma_channel[0]);
+    atomic_set_bits(ADC->CS, ADC_CS_START_MANY);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// stops the capture; the block being filled is discarded
+void adc_capture_stop(void) {
+
+    if (dma_channel[0] < 0) return;
+
+    __adc_halt();
+    atomic_clear_bits(ADC->CS, ADC_CS_RROBIN_MASK);
+
+    // break the chain first, so the aborted channel cannot trigger the other one
+    dma_channel_chain_to(dma_channel[0], dma_channel[0]);
+    dma_channel_chain_to(dma_channel[1], dma_channel[1]);
+    dma_channel_abort(dma_channel[0]);
+    dma_channel_abort(dma_channel[1]);
+
+    dma_channel_unclaim(dma_channel[0]);
+    dma_channel_unclaim(dma_channel[1]);
+    dma_channel[0] = dma_channel[1] = -1;
+    capture_callback = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if samples were lost since the last call: the FIFO has overflowed (the DMA did not keep up) or a block was refilled before
+// its callback ran (the DMA IRQ did not keep up; without the write ring this stops the capture); clears the flags
+bool adc_capture_overrun(void) {
+
+    bool late = capture_late;
+    capture_late = false;
+
+    if (bit_is_clear(ADC->FCS, ADC_FCS_OVER)) return late;
+
+    atomic_set_bits(ADC->FCS, ADC_FCS_OVER);        // write one to clear
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
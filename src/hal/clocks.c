@@ -0,0 +1,81 @@
+#include "hal/clocks.h"
+#include "hal/xosc.h"
+#include "hal/fc0.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define CLOCK_COUNT         10      // number of clock generators
+#define RTC_DIVISOR         1024    // clk_rtc divisor from the 48 MHz USB PLL (46875 Hz)
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint32_t clock_hz[CLOCK_COUNT] = {0};        // frequencies of the clocks [Hz]; 0 if unknown
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// switches a clock to a new auxiliary source; the clock is stopped while switching, so the change is glitch free
+static void __clocks_switch_aux(enum clock_instance clk, enum clock_auxsrc_t auxsrc, uint32_t div) {
+
+    clocks_set_enable(clk, false);
+    clocks_set_aux_source(clk, auxsrc);
+    clocks_set_div(clk, div);
+    clocks_set_enable(clk, true);
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// starts the XOSC and runs the clocks from it: clk_ref from the XOSC, clk_sys and clk_peri from the system PLL, clk_usb and clk_adc from the USB PLL
+// (48 MHz required) and clk_rtc from the USB PLL divided by 1024; the resulting frequencies are stored in the frequency cache
+void clocks_configure(uint32_t xosc_hz, pll_config_t sys_pll, pll_config_t usb_pll) {
+
+    xosc_enable();
+
+    // clk_ref from the XOSC; clk_sys from clk_ref while the PLLs are being reconfigured
+    clocks_set_div(clk_ref, 1);
+    clocks_set_source(clk_ref, CLOCK_SRC_REF_XOSC_CLKSRC);
+    clocks_set_source(clk_sys, CLOCK_SRC_SYS_CLK_REF);
+
+    pll_init(PLL_SYS, sys_pll.fbdiv, sys_pll.postdiv1, sys_pll.postdiv2);
+    pll_init(PLL_USB, usb_pll.fbdiv, usb_pll.postdiv1, usb_pll.postdiv2);
+
+    // clk_sys from the system PLL; the aux mux can be switched safely while the glitchless mux selects clk_ref
+    clocks_set_aux_source(clk_sys, CLOCK_AUXSRC_SYS_CLKSRC_PLL_SYS);
+    clocks_set_div(clk_sys, 1);
+    clocks_set_source(clk_sys, CLOCK_SRC_SYS_CLKSRC_CLK_SYS_AUX);
+
+    __clocks_switch_aux(clk_peri, CLOCK_AUXSRC_PERI_CLK_SYS, 1);
+    __clocks_switch_aux(clk_usb, CLOCK_AUXSRC_USB_CLKSRC_PLL_USB, 1);
+    __clocks_switch_aux(clk_adc, CLOCK_AUXSRC_ADC_CLKSRC_PLL_USB, 1);
+    __clocks_switch_aux(clk_rtc, CLOCK_AUXSRC_RTC_CLKSRC_PLL_USB, RTC_DIVISOR);
+
+    uint32_t sys_hz = pll_config_hz(xosc_hz, sys_pll);
+    uint32_t usb_hz = pll_config_hz(xosc_hz, usb_pll);
+
+    clock_hz[clk_ref] = xosc_hz;
+    clock_hz[clk_sys] = sys_hz;
+    clock_hz[clk_peri] = sys_hz;
+    clock_hz[clk_usb] = usb_hz;
+    clock_hz[clk_adc] = usb_hz;
+    clock_hz[clk_rtc] = usb_hz / RTC_DIVISOR;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the frequency of the clock [Hz]; measured by the frequency counter the first time if it has not been configured by clocks_configure() or clocks_set_hz()
+uint32_t clocks_get_hz(enum clock_instance clk) {
+
+    // the frequency counter sources of clk_ref ... clk_rtc follow the order of the clock generators; the GPIO outputs can't be measured
+    if (clock_hz[clk] == 0 && clk >= clk_ref) clock_hz[clk] = fc0_get_hz(fc0_clk_ref + (clk - clk_ref));
+
+    return (clock_hz[clk]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// stores the frequency of a clock configured by the application to the frequency cache
+void clocks_set_hz(enum clock_instance clk, uint32_t hz) {
+
+    clock_hz[clk] = hz;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,109 @@
+#include "hal/crc.h"
+#include "hal/dma.h"
+#include "utils/crc.h"
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the sniffer mode of a checksum; word transfers need the bytes swapped for the CRC-16, which runs MSB first
+static inline uint32_t __crc_mode(uint8_t type, bool words) {
+
+    switch (type) {
+
+        case crc_crc32:         return (DMA_SNIFF_CTRL_CALC_VAL_CRC32R | DMA_SNIFF_CTRL_OUT_REV | DMA_SNIFF_CTRL_OUT_INV);
+        case crc_crc16_ccitt:   return (DMA_SNIFF_CTRL_CALC_VAL_CRC16 | (words ? DMA_SNIFF_CTRL_BSWAP : 0));
+        default:                return (DMA_SNIFF_CTRL_CALC_VAL_SUM);
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the initial value of the sniffer data register of a checksum
+static inline uint32_t __crc_seed(uint8_t type) {
+
+    switch (type) {
+
+        case crc_crc32:         return CRC32_INIT;
+        case crc_crc16_ccitt:   return CRC16_CCITT_INIT;
+        default:                return 0;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// calculates the checksum in software
+static uint32_t __crc_software(uint8_t type, const void *data, uint32_t len) {
+
+    switch (type) {
+
+        case crc_crc32:         return crc32(data, len);
+        case crc_crc16_ccitt:   return crc16_ccitt(data, len);
+        default:                return checksum_sum(data, len);
+    }
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the checksum (enum crc_type) of len bytes; blocks until the calculation is finished
+uint32_t crc_calculate(uint8_t type, const void *data, uint32_t len) {
+
+    static uint32_t sink;       // write target of the memory-to-null transfer
+
+    if (len == 0 || !dma_sniffer_claim()) return __crc_software(type, data, len);
+
+    int8_t channel = dma_channel_claim();
+    if (channel < 0) {
+
+        dma_sniffer_unclaim();
+        return __crc_software(type, data, len);
+    }
+
+    bool words = (type != crc_sum && ((uint32_t)data & 3) == 0 && (len & 3) == 0);
+
+    dma_channel_config_t config = dma_channel_default_config(channel);
+    config.data_size = words ? dma_size_32 : dma_size_8;
+    config.incr_write = false;
+
+    dma_channel_setup(channel, &config, data, &sink, words ? len >> 2 : len, false);
+    dma_sniffer_enable(channel, __crc_mode(type, words), __crc_seed(type));
+    dma_channel_start(channel);
+    dma_channel_wait(channel);
+
+    uint32_t result = crc_sniff_result(type);
+
+    dma_sniffer_disable(channel);
+    dma_channel_unclaim(channel);
+    dma_sniffer_unclaim();
+
+    return result;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts calculating the checksum (enum crc_type) of the transfers of a claimed DMA channel; returns false if the sniffer is in use
+bool crc_sniff_start(uint8_t channel, uint8_t type) {
+
+    if (!dma_sniffer_claim()) return false;
+
+    dma_sniffer_enable(channel, __crc_mode(type, false), __crc_seed(type));
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the checksum of the data transferred since crc_sniff_start()
+uint32_t crc_sniff_result(uint8_t type) {
+
+    uint32_t result = dma_sniffer_get_data();
+    return (type == crc_crc16_ccitt ? (result & 0xffff) : result);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// detaches the sniffer from the channel and releases it
+void crc_sniff_stop(uint8_t channel) {
+
+    dma_sniffer_disable(channel);
+    dma_sniffer_unclaim();
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,146 @@
+#include "hal/dfs.h"
+#include "hal/clocks.h"
+#include "hal/pll.h"
+#include "hal/timer.h"
+#include "registers/vreg.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define DFS_PLL_MIN_HZ  (PLL_VCO_MIN_HZ / (PLL_POSTDIV_MAX * PLL_POSTDIV_MAX))      // lowest output frequency of the system PLL
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static dfs_notifier_t notifiers[DFS_MAX_NOTIFIERS] = {0};      // registered clock change notifiers
+static uint32_t last_latency_us = 0;                            // latency of the last transition [us]
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the lowest core voltage considered safe for the clk_sys frequency; never lower than the default 1.10 V
+static uint32_t __dfs_vsel_for_hz(uint32_t hz) {
+
+    if (hz <= 133000000) return VREG_VREG_VSEL_VAL_1V10;
+    if (hz <= 200000000) return VREG_VREG_VSEL_VAL_1V15;
+    if (hz <= 250000000) return VREG_VREG_VSEL_VAL_1V20;
+    return VREG_VREG_VSEL_VAL_1V30;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the core voltage and waits until the regulator is in regulation
+static void __dfs_set_vsel(uint32_t vsel) {
+
+    atomic_write_masked(VREG->CTRL, vsel, VREG_VREG_VSEL_MASK, 0);
+    while (bit_is_clear(VREG->CTRL, VREG_VREG_ROK));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// calls all registered notifiers
+static void __dfs_notify(enum dfs_event event, uint32_t clk_sys_hz) {
+
+    for (uint8_t i = 0; i < DFS_MAX_NOTIFIERS; i++) {
+
+        if (notifiers[i] != 0) notifiers[i](event, clk_sys_hz);
+    }
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// registers a notifier called before and after each clk_sys change; registering the same notifier again has no effect. Returns false if there is no free slot
+bool dfs_register_notifier(dfs_notifier_t notifier) {
+
+    int8_t free_slot = -1;
+
+    for (uint8_t i = 0; i < DFS_MAX_NOTIFIERS; i++) {
+
+        if (notifiers[i] == notifier) return true;
+        if (notifiers[i] == 0 && free_slot < 0) free_slot = i;
+    }
+
+    if (free_slot < 0) return false;
+
+    notifiers[free_slot] = notifier;
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// removes a registered notifier
+void dfs_unregister_notifier(dfs_notifier_t notifier) {
+
+    for (uint8_t i = 0; i < DFS_MAX_NOTIFIERS; i++) {
+
+        if (notifiers[i] == notifier) notifiers[i] = 0;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// changes the clk_sys frequency to the nearest frequency the system PLL and the clk_sys integer divider can generate from clk_ref;
+// must not be called from an IRQ. Returns the transition latency [us] or 0 if no frequency within DFS_TOLERANCE_PERCENT can be reached
+uint32_t dfs_set_sys_hz(uint32_t target_hz) {
+
+    uint32_t ref_hz = clocks_get_hz(clk_ref);
+    pll_config_t config;
+
+    if (ref_hz == 0 || target_hz == 0) return 0;
+
+    // the notifiers wait for transfers that are finished by the driver IRQs (I2C, UART and SPI DMA)
+    if (__get_IPSR() != 0 || __get_PRIMASK() != 0) return 0;
+
+    // a target below the lowest PLL output runs the PLL at a multiple of it and divides clk_sys down
+    uint32_t div = 1;
+    while ((uint64_t)target_hz * div < DFS_PLL_MIN_HZ) div++;
+
+    if (!pll_plan(ref_hz, target_hz * div, &config)) return 0;
+
+    uint32_t new_hz = pll_config_hz(ref_hz, config) / div;
+    uint32_t error = (new_hz > target_hz) ? (new_hz - target_hz) : (target_hz - new_hz);
+    if (error > target_hz / 100 * DFS_TOLERANCE_PERCENT) return 0;
+
+    uint64_t start = timer_get_us();
+
+    uint32_t old_vsel = VREG->CTRL & VREG_VREG_VSEL_MASK;
+    uint32_t new_vsel = __dfs_vsel_for_hz(new_hz);
+
+    // raise the voltage before the frequency goes up
+    if (new_vsel > old_vsel) {
+
+        __dfs_set_vsel(new_vsel);
+        uint64_t settled = timer_get_us() + DFS_VREG_SETTLE_US;
+        while (timer_get_us() < settled);
+    }
+
+    __dfs_notify(dfs_pre_change, new_hz);
+
+    // run clk_sys from clk_ref while the PLL is relocked; the aux mux keeps selecting the PLL, which is safe as long as it is not selected by the glitchless mux
+    bool peri_from_sys = ((CLOCKS->CLK[clk_peri].CTRL & CLK_CTRL_AUXSRC_MASK) >> CLK_CTRL_AUXSRC_LSB) == CLOCK_AUXSRC_PERI_CLK_SYS;
+
+    clocks_set_source(clk_sys, CLOCK_SRC_SYS_CLK_REF);
+    pll_init(PLL_SYS, config.fbdiv, config.postdiv1, config.postdiv2);
+    clocks_set_div(clk_sys, div);
+    clocks_set_source(clk_sys, CLOCK_SRC_SYS_CLKSRC_CLK_SYS_AUX);
+
+    clocks_set_hz(clk_sys, new_hz);
+    if (peri_from_sys) clocks_set_hz(clk_peri, new_hz);
+
+    // lower the voltage only after the frequency has gone down
+    if (new_vsel < old_vsel) __dfs_set_vsel(new_vsel);
+
+    __dfs_notify(dfs_post_change, new_hz);
+
+    last_latency_us = (uint32_t)(timer_get_us() - start);
+    if (last_latency_us == 0) last_latency_us = 1;
+
+    return last_latency_us;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the latency of the last successful transition [us]
+uint32_t dfs_get_last_latency_us(void) {
+
+    return last_latency_us;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,153 @@
+#include "hal/divider.h"
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the number of leading zeros of a non-zero number; the Cortex-M0+ has no CLZ instruction
+static uint8_t __divider_clz(uint32_t x) {
+
+    uint8_t n = 0;
+
+    if (x <= 0x0000ffff) {n += 16; x <<= 16;}
+    if (x <= 0x00ffffff) {n +=  8; x <<=  8;}
+    if (x <= 0x0fffffff) {n +=  4; x <<=  4;}
+    if (x <= 0x3fffffff) {n +=  2; x <<=  2;}
+    if (x <= 0x7fffffff) {n +=  1;}
+
+    return n;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// divides the 64-bit number high:low by a 32-bit divisor; high must be lower than the divisor, so the quotient fits into 32 bits.
+// Long division in 16-bit digits with the quotient digits estimated by the hardware divider (Hacker's Delight, divlu)
+static uint32_t __divider_div64_32(uint32_t high, uint32_t low, uint32_t divisor, uint32_t *remainder) {
+
+    uint8_t shift = __divider_clz(divisor);
+
+    // normalize the divisor, so the estimates are off by 2 at most
+    divisor <<= shift;
+    uint32_t divisor_high = divisor >> 16;
+    uint32_t divisor_low = divisor & 0xffff;
+
+    uint32_t n32 = (shift == 0) ? high : (high << shift) | (low >> (32 - shift));
+    uint32_t n10 = low << shift;
+    uint32_t n1 = n10 >> 16;
+    uint32_t n0 = n10 & 0xffff;
+
+    divmod_u32_t estimate = divider_divmod_u32(n32, divisor_high);
+    uint32_t q1 = estimate.quotient;
+    uint32_t rhat = estimate.remainder;
+
+    while (q1 > 0xffff || q1 * divisor_low > ((rhat << 16) | n1)) {
+
+        q1--;
+        rhat += divisor_high;
+        if (rhat > 0xffff) break;
+    }
+
+    uint32_t n21 = (n32 << 16) + n1 - q1 * divisor;
+
+    estimate = divider_divmod_u32(n21, divisor_high);
+    uint32_t q0 = estimate.quotient;
+    rhat = estimate.remainder;
+
+    while (q0 > 0xffff || q0 * divisor_low > ((rhat << 16) | n0)) {
+
+        q0--;
+        rhat += divisor_high;
+        if (rhat > 0xffff) break;
+    }
+
+    *remainder = ((n21 << 16) + n0 - q0 * divisor) >> shift;
+
+    return ((q1 << 16) | q0);
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// divides 64-bit unsigned numbers; the remainder is stored to *remainder (may be 0). Division by zero returns all ones and the numerator as the remainder
+uint64_t divider_divmod_u64(uint64_t numerator, uint64_t denominator, uint64_t *remainder) {
+
+    uint32_t n_high = numerator >> 32;
+    uint32_t d_high = denominator >> 32;
+    uint32_t d_low = (uint32_t)denominator;
+    uint64_t quotient;
+    uint64_t rem;
+
+    // the steps use the divider directly; keep the state of an interrupted division
+    divider_state_t saved;
+    bool dirty = divider_is_dirty();
+    if (dirty) divider_save_state(&saved);
+
+    if (denominator == 0) {
+
+        quotient = ~(uint64_t)0;
+        rem = numerator;
+
+    // 32 / 32 bits; a single hardware division
+    } else if (n_high == 0 && d_high == 0) {
+
+        divmod_u32_t result = divider_divmod_u32((uint32_t)numerator, d_low);
+        quotient = result.quotient;
+        rem = result.remainder;
+
+    // 64 / 32 bits; the high word first, then the rest with a quotient that fits into 32 bits
+    } else if (d_high == 0) {
+
+        divmod_u32_t result = divider_divmod_u32(n_high, d_low);
+        uint32_t r;
+        uint32_t q_low = __divider_div64_32(result.remainder, (uint32_t)numerator, d_low, &r);
+
+        quotient = ((uint64_t)result.quotient << 32) | q_low;
+        rem = r;
+
+    // 64 / 64 bits; the quotient fits into 32 bits and is estimated from the normalized top 32 bits of the denominator (Hacker's Delight, divDu)
+    } else if (numerator < denominator) {
+
+        quotient = 0;
+        rem = numerator;
+
+    } else {
+
+        uint8_t shift = __divider_clz(d_high);
+        uint32_t d_top = (uint32_t)((denominator << shift) >> 32);
+        uint64_t n_half = numerator >> 1;
+        uint32_t r;
+
+        uint32_t q = __divider_div64_32((uint32_t)(n_half >> 32), (uint32_t)n_half, d_top, &r);
+        q = (uint32_t)(((uint64_t)q << shift) >> 31);
+        if (q != 0) q--;
+
+        rem = numerator - (uint64_t)q * denominator;
+        if (rem >= denominator) {
+
+            q++;
+            rem -= denominator;
+        }
+
+        quotient = q;
+    }
+
+    if (dirty) divider_restore_state(&saved);
+
+    if (remainder != 0) *remainder = rem;
+    return quotient;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// divides 64-bit signed numbers, rounding towards zero; the remainder has the sign of the numerator and is stored to *remainder (may be 0)
+int64_t divider_divmod_s64(int64_t numerator, int64_t denominator, int64_t *remainder) {
+
+    bool n_negative = (numerator < 0);
+    bool d_negative = (denominator < 0);
+
+    uint64_t rem;
+    uint64_t quotient = divider_divmod_u64(n_negative ? -(uint64_t)numerator : (uint64_t)numerator,
+                                           d_negative ? -(uint64_t)denominator : (uint64_t)denominator, &rem);
+
+    if (remainder != 0) *remainder = n_negative ? -(int64_t)rem : (int64_t)rem;
+    return ((n_negative != d_negative) ? -(int64_t)quotient : (int64_t)quotient);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,347 @@
+#include "hal/dma.h"
+#include "hal/resets.h"
+#include "hal/spinlock.h"
+#include "utils/string.h"
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static volatile uint32_t claimed_channels = 0;                      // bit mask of channels in use
+static dma_callback_t channel_callback[DMA_CHANNEL_COUNT] = {0};    // completion callbacks of the channels
+static volatile uint32_t irq1_channels = 0;                         // bit mask of channels routed to DMA_IRQ1
+static dma_async_t *async_handle[DMA_CHANNEL_COUNT] = {0};          // handles of the asynchronous memory operations in progress
+static volatile bool sniffer_claimed = false;                       // the sniffer is in use
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the interrupt enable register of the channel's IRQ line
+static inline volatile uint32_t *__channel_inte(uint8_t channel) {
+
+    return (bit_is_set(irq1_channels, (1 << channel)) ? &DMA->INTE1 : &DMA->INTE0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the interrupt status register of the channel's IRQ line
+static inline volatile uint32_t *__channel_ints(uint8_t channel) {
+
+    return (bit_is_set(irq1_channels, (1 << channel)) ? &DMA->INTS1 : &DMA->INTS0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// completes an asynchronous memory operation; releases the channel and wakes up the cores waiting in dma_async_wait()
+static void __dma_async_complete(uint8_t channel) {
+
+    dma_async_t *handle = async_handle[channel];
+    async_handle[channel] = 0;
+
+    dma_channel_unclaim(channel);
+
+    handle->channel = -1;
+    handle->busy = false;
+    __SEV();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts an unpaced word transfer of an asynchronous memory operation; returns false if no channel is free
+static bool __dma_async_start(dma_async_t *handle, volatile void *dest, const volatile void *src, uint32_t words, bool incr_read) {
+
+    int8_t channel = dma_channel_claim();
+    if (channel < 0) return false;
+
+    handle->channel = channel;
+    handle->busy = true;
+    async_handle[channel] = handle;
+
+    dma_channel_config_t config = dma_channel_default_config(channel);
+    config.incr_read = incr_read;
+
+    dma_channel_set_callback(channel, __dma_async_complete);
+    dma_channel_setup(channel, &config, src, dest, words, true);
+
+    return true;
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// initializes the DMA block; releases all channels
+void dma_init(void) {
+
+    resets_reset_block(RESETS_DMA);
+    resets_unreset_block(RESETS_DMA);
+
+    claimed_channels = 0;
+    irq1_channels = 0;
+    sniffer_claimed = false;
+    for (uint8_t channel = 0; channel < DMA_CHANNEL_COUNT; channel++) channel_callback[channel] = 0;
+
+    NVIC_EnableIRQ(DMA_IRQ0);
+    NVIC_SetPriority(DMA_IRQ0, 0);
+    NVIC_EnableIRQ(DMA_IRQ1);
+    NVIC_SetPriority(DMA_IRQ1, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// claims an unused DMA channel; returns the channel number or -1 if all channels are in use
+int8_t dma_channel_claim(void) {
+
+    int8_t claimed = -1;
+
+    // channels may be claimed from an interrupt context and from both cores
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_dma);
+
+    for (uint8_t channel = 0; channel < DMA_CHANNEL_COUNT; channel++) {
+
+        if (bit_is_clear(claimed_channels, (1 << channel))) {
+
+            set_bits(claimed_channels, (1 << channel));
+            claimed = channel;
+            break;
+        }
+    }
+
+    spinlock_unlock_irqrestore(spinlock_id_dma, primask);
+
+    return claimed;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// releases a claimed DMA channel; a transfer in progress is aborted, the channel is disabled and its interrupt is turned off
+void dma_channel_unclaim(uint8_t channel) {
+
+    // disabling a paced channel only pauses it; the next owner would resume the stale transfer
+    dma_channel_set_callback(channel, 0);
+    dma_channel_abort(channel);
+    DMA->CH[channel].AL1_CTRL = 0;
+
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_dma);
+    clear_bits(irq1_channels, (1 << channel));
+    clear_bits(claimed_channels, (1 << channel));
+    spinlock_unlock_irqrestore(spinlock_id_dma, primask);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// sets the completion callback of a channel and enables its interrupt on the channel's IRQ line; passing 0 disables the interrupt
+void dma_channel_set_callback(uint8_t channel, dma_callback_t callback) {
+
+    channel_callback[channel] = callback;
+
+    if (callback != 0) {
+
+        *__channel_ints(channel) = (1 << channel);      // discard a stale completion flag
+        atomic_set_bits(*__channel_inte(channel), (1 << channel));
+
+    } else atomic_clear_bits(*__channel_inte(channel), (1 << channel));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// selects the IRQ line (enum dma_irq_line) the completion interrupt of a channel is routed to; an enabled interrupt is moved to the new line
+void dma_channel_set_irq_line(uint8_t channel, uint8_t line) {
+
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_dma);
+
+    bool enabled = bit_is_set(*__channel_inte(channel), (1 << channel));
+    atomic_clear_bits(*__channel_inte(channel), (1 << channel));
+
+    if (line == dma_irq_1) set_bits(irq1_channels, (1 << channel));
+    else clear_bits(irq1_channels, (1 << channel));
+
+    if (enabled) atomic_set_bits(*__channel_inte(channel), (1 << channel));
+
+    spinlock_unlock_irqrestore(spinlock_id_dma, primask);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// stops the transfer of a DMA channel and waits until the channel has finished its outstanding bus transfers
+// the completion flag raised by the abort (RP2040-E13) is discarded, so the channel's callback is not called
+void dma_channel_abort(uint8_t channel) {
+
+    // RP2040-E13: an aborted channel raises its completion interrupt; the interrupt is masked during the abort
+    volatile uint32_t *inte = __channel_inte(channel);
+    bool enabled = bit_is_set(*inte, (1 << channel));
+    atomic_clear_bits(*inte, (1 << channel));
+
+    DMA->CHAN_ABORT = (1 << channel);
+    while (bit_is_set(DMA->CHAN_ABORT, (1 << channel)));
+
+    *__channel_ints(channel) = (1 << channel);
+    if (enabled) atomic_set_bits(*inte, (1 << channel));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// copies len bytes from src to dest (the buffers must not overlap); the copy is finished when dma_async_busy() returns false
+void dma_memcpy_async(dma_async_t *handle, void *dest, const void *src, uint32_t len) {
+
+    uint8_t *d = dest;
+    const uint8_t *s = src;
+
+    handle->channel = -1;
+    handle->busy = false;
+
+    // the DMA moves words, so both buffers have to reach word alignment at the same offset
+    if (len < DMA_ASYNC_MIN_LEN || (((uint32_t)d ^ (uint32_t)s) & 3) != 0) {
+
+        memcpy(d, s, len);
+        return;
+    }
+
+    uint32_t head = (-(uint32_t)d) & 3;
+    uint32_t words = (len - head) >> 2;
+    uint32_t tail = (len - head) & 3;
+
+    memcpy(d, s, head);
+    memcpy(d + head + (words << 2), s + head + (words << 2), tail);
+
+    if (!__dma_async_start(handle, d + head, s + head, words, true)) memcpy(d + head, s + head, words << 2);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// fills len bytes of dest with val; the fill is finished when dma_async_busy() returns false
+void dma_memset_async(dma_async_t *handle, void *dest, uint8_t val, uint32_t len) {
+
+    uint8_t *d = dest;
+
+    handle->channel = -1;
+    handle->busy = false;
+
+    if (len < DMA_ASYNC_MIN_LEN) {
+
+        memset(d, val, len);
+        return;
+    }
+
+    uint32_t head = (-(uint32_t)d) & 3;
+    uint32_t words = (len - head) >> 2;
+    uint32_t tail = (len - head) & 3;
+
+    memset(d, val, head);
+    memset(d + head + (words << 2), val, tail);
+
+    handle->pattern = (uint32_t)val * 0x01010101u;
+    if (!__dma_async_start(handle, d + head, &handle->pattern, words, false)) memset(d + head, val, words << 2);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// claims the channel pair of a scatter-gather transfer; returns false if there are not enough free channels
+bool dma_sg_claim(dma_sg_t *sg) {
+
+    sg->control_channel = dma_channel_claim();
+    sg->data_channel = dma_channel_claim();
+
+    if (sg->control_channel < 0 || sg->data_channel < 0) {
+
+        if (sg->control_channel >= 0) dma_channel_unclaim(sg->control_channel);
+        if (sg->data_channel >= 0) dma_channel_unclaim(sg->data_channel);
+        sg->control_channel = sg->data_channel = -1;
+        return false;
+    }
+
+    // each descriptor is written to the AL3 registers of the data channel; the write address wraps on the 16-byte register block
+    dma_channel_config_t config = dma_channel_default_config(sg->control_channel);
+    config.ring_size_bits = 4;
+    config.ring_write = true;
+
+    dma_channel_setup(sg->control_channel, &config, 0, &DMA->CH[sg->data_channel].AL3_CTRL, sizeof(dma_sg_descriptor_t) / 4, false);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// releases the channel pair of a scatter-gather transfer
+void dma_sg_unclaim(dma_sg_t *sg) {
+
+    dma_sg_abort(sg);
+    dma_channel_unclaim(sg->control_channel);
+    dma_channel_unclaim(sg->data_channel);
+    sg->control_channel = sg->data_channel = -1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// starts the transfer of a descriptor list terminated by dma_sg_end(); the list must stay valid until the transfer completes
+void dma_sg_start(dma_sg_t *sg, const dma_sg_descriptor_t *list) {
+
+    DMA->CH[sg->control_channel].WRITE_ADDR = (uint32_t)&DMA->CH[sg->data_channel].AL3_CTRL;
+    DMA->CH[sg->control_channel].AL3_READ_ADDR_TRIG = (uint32_t)list;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// stops a scatter-gather transfer
+void dma_sg_abort(dma_sg_t *sg) {
+
+    // the data channel may finish a segment while the control channel is aborted and trigger it again through the chain
+    dma_channel_abort(sg->control_channel);
+    dma_channel_abort(sg->data_channel);
+    if (dma_channel_busy(sg->control_channel)) {
+
+        dma_channel_abort(sg->control_channel);
+        dma_channel_abort(sg->data_channel);
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// claims the sniffer; returns false if it is in use
+bool dma_sniffer_claim(void) {
+
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_dma);
+
+    bool claimed = !sniffer_claimed;
+    sniffer_claimed = true;
+
+    spinlock_unlock_irqrestore(spinlock_id_dma, primask);
+
+    return claimed;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// releases the claimed sniffer
+void dma_sniffer_unclaim(void) {
+
+    DMA->SNIFF_CTRL = 0;
+    sniffer_claimed = false;
+}
+
+//---- IRQ HANDLERS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// dispatches the completion flags of one IRQ line to the channel callbacks
+static force_inline void __dma_irq_handler(volatile uint32_t *ints) {
+
+    uint32_t status = *ints;
+    *ints = status;             // acknowledge the IRQ
+
+    for (uint8_t channel = 0; channel < DMA_CHANNEL_COUNT; channel++) {
+
+        if (bit_is_set(status, (1 << channel)) && channel_callback[channel] != 0) channel_callback[channel](channel);
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// triggered when a channel routed to DMA_IRQ0 finishes a transfer
+void DMA0_Handler() {
+
+    __dma_irq_handler(&DMA->INTS0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// triggered when a channel routed to DMA_IRQ1 finishes a transfer
+void DMA1_Handler() {
+
+    __dma_irq_handler(&DMA->INTS1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
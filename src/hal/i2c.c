@@ -2,45 +2,467 @@
 #include "hal/resets.h"
 #include "hal/clocks.h"
 #include "hal/gpio.h"
-#include "hal/fc0.h"
+#include "hal/dma.h"
+#include "hal/dfs.h"
+#include "hal/spinlock.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define I2C_FIFO_DEPTH      16      // depth of the hardware TX and RX FIFOs
+#define I2C_TX_LEVEL        4       // the TX_EMPTY interrupt fires when the TX FIFO drains to this level
+#define I2C_RX_LEVEL        8       // maximum number of bytes collected in the RX FIFO before the RX_FULL interrupt fires
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static i2c_transaction_t *queue_head[2] = {0};      // transaction in progress, followed by the queued ones
+static i2c_transaction_t *queue_tail[2] = {0};      // last queued transaction
+
+static int8_t tx_dma_channel[2] = {-1, -1};         // DMA channel feeding the read commands to DATA_CMD; -1 if the DMA mode is disabled
+static int8_t rx_dma_channel[2] = {-1, -1};         // DMA channel moving the received bytes to the buffer of the transaction
+static bool dma_active[2] = {false};                // the transaction in progress is executed by the DMA
+
+static uint32_t i2c_baudrate[2] = {0};              // baud rate of the initialized I2Cs; 0 if the I2C is not initialized
+static volatile bool queue_held[2] = {false};       // the queued transactions are held back while the clocks are being changed
+
+// read commands for the TX DMA; only the last one generates a stop condition, so a read of N bytes uses the last N entries
+static uint32_t dma_read_commands[I2C_DMA_MAX_READ];
 
 // returns 0 if argument is I2C0; returns 1 if argument is I2C1
 #define i2c_get_index(i2c) (i2c == I2C1)
 
+// spinlock protecting the transaction queue of the instance; transactions may be submitted from both cores
+#define i2c_lock(index) ((index) ? spinlock_id_i2c1 : spinlock_id_i2c0)
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// moves the received bytes from the RX FIFO to the buffer of the transaction
+static void __i2c_drain_rx(I2C_t *i2c, i2c_transaction_t *transaction) {
+
+    while (i2c->RXFLR > 0 && transaction->rx_index < transaction->rx_len) transaction->rx_data[transaction->rx_index++] = i2c->DATA_CMD;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// writes as many commands of the transaction to the TX FIFO as there is room for, then unmasks the interrupts the transaction is waiting for
+static void __i2c_fill_tx(I2C_t *i2c, i2c_transaction_t *transaction) {
+
+    uint16_t total = transaction->tx_len + transaction->rx_len;
+    bool rx_blocked = false;
+
+    while (transaction->cmd_index < total && i2c->TXFLR < I2C_FIFO_DEPTH) {
+
+        uint32_t cmd;
+
+        if (transaction->cmd_index < transaction->tx_len) cmd = transaction->tx_data[transaction->cmd_index];
+
+        else {
+
+            // don't request more bytes than the RX FIFO can hold
+            if (transaction->cmd_index - transaction->tx_len - transaction->rx_index >= I2C_FIFO_DEPTH) {
+
+                rx_blocked = true;
+                break;
+            }
+
+            cmd = I2C_DATA_CMD_CMD;
+            if (transaction->cmd_index == transaction->tx_len && transaction->tx_len != 0) cmd |= I2C_DATA_CMD_RESTART;
+        }
+
+        if (transaction->cmd_index == total - 1) cmd |= I2C_DATA_CMD_STOP;
+
+        i2c->DATA_CMD = cmd;
+        transaction->cmd_index++;
+    }
+
+    uint32_t mask = I2C_INTR_TX_ABRT | I2C_INTR_STOP_DET;
+
+    // more commands to send; refill when the TX FIFO runs low
+    if (transaction->cmd_index < total && !rx_blocked) mask |= I2C_INTR_TX_EMPTY;
+
+    // read commands waiting for data; collect up to I2C_RX_LEVEL bytes per interrupt
+    uint32_t pending_rx = (transaction->cmd_index > transaction->tx_len) ? (transaction->cmd_index - transaction->tx_len - transaction->rx_index) : 0;
+    if (pending_rx > 0) {
+
+        i2c->RX_TL = (pending_rx < I2C_RX_LEVEL ? pending_rx : I2C_RX_LEVEL) - 1;
+        mask |= I2C_INTR_RX_FULL;
+    }
+
+    i2c->INTR_MASK = mask;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the transaction can be executed by the DMA; the write part must fit into the TX FIFO
+static force_inline bool __i2c_dma_eligible(I2C_t *i2c, i2c_transaction_t *transaction) {
+
+    return (tx_dma_channel[i2c_get_index(i2c)] >= 0 && transaction->rx_len != 0 && transaction->rx_len <= I2C_DMA_MAX_READ && transaction->tx_len <= I2C_FIFO_DEPTH);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// writes the write part of the transaction to the TX FIFO and hands the read part over to the DMA; the direction change generates the repeated start
+static void __i2c_start_dma(I2C_t *i2c, i2c_transaction_t *transaction) {
+
+    uint8_t index = i2c_get_index(i2c);
+
+    for (uint16_t i = 0; i < transaction->tx_len; i++) i2c->DATA_CMD = transaction->tx_data[i];
+    transaction->cmd_index = transaction->tx_len + transaction->rx_len;
+
+    dma_active[index] = true;
+    dma_channel_transfer_to(rx_dma_channel[index], transaction->rx_data, transaction->rx_len);
+    dma_channel_transfer_from(tx_dma_channel[index], &dma_read_commands[I2C_DMA_MAX_READ - transaction->rx_len], transaction->rx_len);
+
+    i2c->INTR_MASK = I2C_INTR_TX_ABRT | I2C_INTR_STOP_DET;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// starts the transaction at the head of the queue; masks all interrupts if the queue is empty
+static void __i2c_start_next(I2C_t *i2c) {
+
+    i2c_transaction_t *transaction = queue_head[i2c_get_index(i2c)];
+
+    if (transaction == 0 || queue_held[i2c_get_index(i2c)]) {
+
+        i2c->INTR_MASK = 0;
+        return;
+    }
+
+    transaction->cmd_index = 0;
+    transaction->rx_index = 0;
+    transaction->abort_source = 0;
+    transaction->status = i2c_busy;
+
+    // the target address can only be changed while the block is disabled
+    i2c->ENABLE = 0;
+    i2c->TAR = transaction->address;
+    i2c->ENABLE = 1;
+
+    (void)i2c->CLR_INTR;        // clear the interrupts left over from the previous transaction
+
+    dma_active[i2c_get_index(i2c)] = false;
+
+    if (__i2c_dma_eligible(i2c, transaction)) __i2c_start_dma(i2c, transaction);
+    else __i2c_fill_tx(i2c, transaction);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// aborts the transaction in progress, which did not finish in time (e.g. the bus is stuck); the transaction is completed as aborted
+// by the user (I2C_TX_ABRT_SOURCE_ABRT_USER_ABRT) and the next one is not started
+static void __i2c_abort_current(I2C_t *i2c) {
+
+    uint8_t index = i2c_get_index(i2c);
+
+    uint32_t primask = spinlock_lock_irqsave(i2c_lock(index));
+
+    i2c_transaction_t *transaction = queue_head[index];
+    if (transaction == 0 || transaction->status != i2c_busy) {
+
+        spinlock_unlock_irqrestore(i2c_lock(index), primask);
+        return;
+    }
+
+    // the interrupts of the aborted transaction are discarded; __i2c_start_next() clears them before the next transaction
+    i2c->INTR_MASK = 0;
+    atomic_set_bits(i2c->ENABLE, I2C_ENABLE_ABORT);
+
+    if (dma_active[index]) {
+
+        dma_channel_abort(tx_dma_channel[index]);
+        dma_channel_abort(rx_dma_channel[index]);
+        transaction->rx_index = transaction->rx_len - DMA->CH[rx_dma_channel[index]].TRANS_COUNT;
+        dma_active[index] = false;
+    }
+
+    queue_head[index] = transaction->next;
+    if (transaction->next == 0) queue_tail[index] = 0;
+
+    spinlock_unlock_irqrestore(i2c_lock(index), primask);
+
+    // the hardware clears ABORT once it has flushed the TX FIFO and generated the stop condition; a bus held low by a slave never completes it
+    uint64_t deadline = timer_get_us() + I2C_ABORT_TIMEOUT_US;
+    while (bit_is_set(i2c->ENABLE, I2C_ENABLE_ABORT) && timer_get_us() < deadline);
+
+    transaction->abort_source = I2C_TX_ABRT_SOURCE_ABRT_USER_ABRT;
+    transaction->status = i2c_aborted;
+
+    if (transaction->callback != 0) transaction->callback(transaction);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called by the DFS service around a clk_sys change; the transaction in progress is finished (or aborted after I2C_DFS_TIMEOUT_US)
+// and the queue is held until the timing is recalculated. The wait relies on the I2C IRQ, so the DFS service calls it from thread mode with the IRQs enabled
+static void __i2c_clock_changed(enum dfs_event event, uint32_t clk_sys_hz) {
+
+    (void)clk_sys_hz;
+
+    for (uint8_t index = 0; index < 2; index++) {
+
+        I2C_t *i2c = index ? I2C1 : I2C0;
+        if (i2c_baudrate[index] == 0) continue;
+
+        if (event == dfs_pre_change) {
+
+            queue_held[index] = true;
+
+            uint64_t deadline = timer_get_us() + I2C_DFS_TIMEOUT_US;
+            while (queue_head[index] != 0 && queue_head[index]->status == i2c_busy && timer_get_us() < deadline);
+
+            if (queue_head[index] != 0 && queue_head[index]->status == i2c_busy) __i2c_abort_current(i2c);
+
+        } else {
+
+            i2c_set_baudrate(i2c, i2c_baudrate[index]);
+
+            uint32_t primask = spinlock_lock_irqsave(i2c_lock(index));
+            queue_held[index] = false;
+            if (queue_head[index] != 0 && queue_head[index]->status == i2c_queued) __i2c_start_next(i2c);
+            spinlock_unlock_irqrestore(i2c_lock(index), primask);
+        }
+    }
+}
+
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the I2C hardware
+// initializes the I2C hardware; an instance that is already initialized is deinitialized first
 void i2c_init(I2C_t *i2c, uint32_t baudrate, uint8_t sda_pin, uint8_t scl_pin) {
 
-    resets_reset_block(i2c_get_index(i2c) ? RESETS_I2C1 : RESETS_I2C0);
+    // releases the DMA channels and completes the queued transactions of a previous initialization as aborted
+    i2c_deinit(i2c);
     resets_unreset_block(i2c_get_index(i2c) ? RESETS_I2C1 : RESETS_I2C0);
+    dfs_register_notifier(__i2c_clock_changed);
 
     gpio_set_function(sda_pin, GPIO_FUNC_I2C);
     gpio_set_function(scl_pin, GPIO_FUNC_I2C);
 
     i2c->ENABLE = 0;
-    i2c->CON = I2C_CON_IC_SLAVE_DISABLE | I2C_CON_IC_RESTART_EN | I2C_CON_SPEED_VAL_FAST | I2C_CON_MASTER_MODE;
+    // hold the bus instead of losing data when the RX FIFO is full
+    i2c->CON = I2C_CON_RX_FIFO_FULL_HLD_CTRL | I2C_CON_IC_SLAVE_DISABLE | I2C_CON_IC_RESTART_EN | I2C_CON_SPEED_VAL_FAST | I2C_CON_MASTER_MODE;
+
+    i2c_set_baudrate(i2c, baudrate);
+
+    i2c->TX_TL = I2C_TX_LEVEL;
+    i2c->RX_TL = 0;
+    i2c->INTR_MASK = 0;
+
+    i2c->ENABLE = 1;
+
+    NVIC_EnableIRQ(i2c_get_index(i2c) ? I2C_IRQ1 : I2C_IRQ0);
+    NVIC_SetPriority(i2c_get_index(i2c) ? I2C_IRQ1 : I2C_IRQ0, 0);
+}
 
-    uint32_t freq_in = fc0_get_hz(fc0_clk_sys);
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the baud rate according to the current clk_sys frequency; the block is disabled while the timing is changed, so no transfer may be in progress
+void i2c_set_baudrate(I2C_t *i2c, uint32_t baudrate) {
+
+    i2c_baudrate[i2c_get_index(i2c)] = baudrate;
+
+    uint32_t enabled = i2c->ENABLE;
+    i2c->ENABLE = 0;
+
+    uint32_t freq_in = clocks_get_hz(clk_sys);
     uint32_t period = (freq_in + baudrate / 2) / baudrate;
     uint32_t lcnt = period * 3 / 5;
     uint32_t hcnt = period - lcnt;
-    uint32_t sda_tx_hold_count = ((freq_in * 3) / 10000000000) + 1;
+    uint32_t sda_tx_hold_count = ((freq_in * 3) / 10000000) + 1;       // 300 ns
     
     i2c->FS_SCL_HCNT = hcnt;                        // SCL high clock period (Fast Speed)
     i2c->FS_SCL_LCNT = lcnt;                        // SCL low clock period (Fast Speed)
     i2c->FS_SPKLEN = lcnt < 16 ? 1 : lcnt / 16;     // Spike length = low clock period / 16
-    write_masked(i2c->SDA_HOLD, sda_tx_hold_count, 0xffff, 0);  // Data hold time
+    atomic_write_masked(i2c->SDA_HOLD, sda_tx_hold_count, 0xffff, 0);  // Data hold time
 
-    i2c->ENABLE = 1;
+    i2c->ENABLE = enabled & I2C_ENABLE_ENABLE;     // the self-clearing ABORT and TX_CMD_BLOCK bits must not be written back
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// deinitializes the I2C hardware
+// deinitializes the I2C hardware; queued transactions are completed as aborted (I2C_TX_ABRT_SOURCE_ABRT_USER_ABRT) and their callbacks
+// are called from the calling context
 void i2c_deinit(I2C_t *i2c) {
 
+    NVIC_DisableIRQ(i2c_get_index(i2c) ? I2C_IRQ1 : I2C_IRQ0);
     resets_reset_block(i2c_get_index(i2c) ? RESETS_I2C1 : RESETS_I2C0);
+    i2c_baudrate[i2c_get_index(i2c)] = 0;
+
+    // release the DMA channels if the DMA mode was enabled; unclaiming aborts them, the block reset above has removed their DREQs
+    if (tx_dma_channel[i2c_get_index(i2c)] >= 0) {
+
+        dma_channel_unclaim(tx_dma_channel[i2c_get_index(i2c)]);
+        dma_channel_unclaim(rx_dma_channel[i2c_get_index(i2c)]);
+        tx_dma_channel[i2c_get_index(i2c)] = -1;
+        rx_dma_channel[i2c_get_index(i2c)] = -1;
+        dma_active[i2c_get_index(i2c)] = false;
+    }
+
+    // detach the queue first; a callback resubmitting its transaction is refused while the I2C is not initialized
+    uint32_t primask = spinlock_lock_irqsave(i2c_lock(i2c_get_index(i2c)));
+
+    i2c_transaction_t *transaction = queue_head[i2c_get_index(i2c)];
+    queue_head[i2c_get_index(i2c)] = 0;
+    queue_tail[i2c_get_index(i2c)] = 0;
+    queue_held[i2c_get_index(i2c)] = false;
+
+    spinlock_unlock_irqrestore(i2c_lock(i2c_get_index(i2c)), primask);
+
+    while (transaction != 0) {
+
+        i2c_transaction_t *next = transaction->next;
+
+        transaction->abort_source = I2C_TX_ABRT_SOURCE_ABRT_USER_ABRT;
+        transaction->status = i2c_aborted;
+        if (transaction->callback != 0) transaction->callback(transaction);
+
+        transaction = next;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// switches reads to DMA mode: reads of up to I2C_DMA_MAX_READ bytes are executed by two DMA channels paced by the I2C DREQs,
+// with a single interrupt at the end of the transaction; the DMA needs to be initialized first. Returns false if there are not two DMA channels available
+bool i2c_enable_dma(I2C_t *i2c) {
+
+    uint8_t index = i2c_get_index(i2c);
+    if (tx_dma_channel[index] >= 0) return true;
+
+    int8_t tx_channel = dma_channel_claim();
+    if (tx_channel < 0) return false;
+
+    int8_t rx_channel = dma_channel_claim();
+    if (rx_channel < 0) {
+
+        dma_channel_unclaim(tx_channel);
+        return false;
+    }
+
+    for (uint32_t i = 0; i < I2C_DMA_MAX_READ - 1; i++) dma_read_commands[i] = I2C_DATA_CMD_CMD;
+    dma_read_commands[I2C_DMA_MAX_READ - 1] = I2C_DATA_CMD_CMD | I2C_DATA_CMD_STOP;
+
+    dma_channel_configure(tx_channel, 0, &i2c->DATA_CMD, 0, DMA_CTRL_EN | DMA_CTRL_INCR_READ | DMA_CTRL_DATA_SIZE_VAL_WORD |
+                          ((index ? DMA_DREQ_I2C1_TX : DMA_DREQ_I2C0_TX) << DMA_CTRL_TREQ_SEL_LSB));
+    dma_channel_configure(rx_channel, &i2c->DATA_CMD, 0, 0, DMA_CTRL_EN | DMA_CTRL_INCR_WRITE | DMA_CTRL_DATA_SIZE_VAL_BYTE |
+                          ((index ? DMA_DREQ_I2C1_RX : DMA_DREQ_I2C0_RX) << DMA_CTRL_TREQ_SEL_LSB));
+
+    NVIC_DisableIRQ(index ? I2C_IRQ1 : I2C_IRQ0);
+
+    tx_dma_channel[index] = tx_channel;
+    rx_dma_channel[index] = rx_channel;
+    i2c->DMA_CR = I2C_DMA_CR_TDMAE | I2C_DMA_CR_RDMAE;
+
+    NVIC_EnableIRQ(index ? I2C_IRQ1 : I2C_IRQ0);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// queues a transaction; it starts immediately if the bus is idle. Returns false if the I2C is not initialized, the transaction is empty or already queued
+bool i2c_submit(I2C_t *i2c, i2c_transaction_t *transaction) {
+
+    if (i2c_baudrate[i2c_get_index(i2c)] == 0) return false;
+    if (transaction->tx_len == 0 && transaction->rx_len == 0) return false;
+    if (transaction->tx_len != 0 && transaction->tx_data == 0) return false;
+    if (transaction->rx_len != 0 && transaction->rx_data == 0) return false;
+    if (transaction->status == i2c_queued || transaction->status == i2c_busy) return false;
+
+    transaction->status = i2c_queued;
+    transaction->next = 0;
+
+    // the IRQ of this instance modifies the queue as well
+    uint32_t primask = spinlock_lock_irqsave(i2c_lock(i2c_get_index(i2c)));
+
+    if (queue_tail[i2c_get_index(i2c)] != 0) queue_tail[i2c_get_index(i2c)]->next = transaction;
+    else queue_head[i2c_get_index(i2c)] = transaction;
+    queue_tail[i2c_get_index(i2c)] = transaction;
+
+    if (queue_head[i2c_get_index(i2c)] == transaction) __i2c_start_next(i2c);
+
+    spinlock_unlock_irqrestore(i2c_lock(i2c_get_index(i2c)), primask);
+
+    return true;
+}
+
+//---- IRQ HANDLERS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static force_inline void i2c_handler(I2C_t *i2c) {
+
+    spinlock_lock(i2c_lock(i2c_get_index(i2c)));
+
+    uint32_t status = i2c->INTR_STAT;
+    i2c_transaction_t *transaction = queue_head[i2c_get_index(i2c)];
+
+    if (transaction == 0) {
+
+        i2c->INTR_MASK = 0;
+        (void)i2c->CLR_INTR;
+        spinlock_unlock(i2c_lock(i2c_get_index(i2c)));
+        return;
+    }
+
+    // the slave did not acknowledge or the arbitration was lost; the hardware flushes the TX FIFO and generates a stop condition
+    if (bit_is_set(status, I2C_INTR_TX_ABRT)) {
+
+        transaction->abort_source = i2c->TX_ABRT_SOURCE;
+        (void)i2c->CLR_TX_ABRT;
+        transaction->cmd_index = transaction->tx_len + transaction->rx_len;     // don't send any more commands
+
+        // the read commands would be flushed anyway and no more data will arrive
+        if (dma_active[i2c_get_index(i2c)]) {
+
+            dma_channel_abort(tx_dma_channel[i2c_get_index(i2c)]);
+            dma_channel_abort(rx_dma_channel[i2c_get_index(i2c)]);
+        }
+    }
+
+    if (!dma_active[i2c_get_index(i2c)]) __i2c_drain_rx(i2c, transaction);
+
+    // the transaction has finished
+    if (bit_is_set(status, I2C_INTR_STOP_DET)) {
+
+        (void)i2c->CLR_STOP_DET;
+
+        // the last bytes are already in the RX FIFO, give the DMA the few cycles it needs to move them
+        if (dma_active[i2c_get_index(i2c)]) {
+
+            if (transaction->abort_source == 0) while (dma_channel_busy(rx_dma_channel[i2c_get_index(i2c)]));
+            transaction->rx_index = transaction->rx_len - DMA->CH[rx_dma_channel[i2c_get_index(i2c)]].TRANS_COUNT;
+            dma_active[i2c_get_index(i2c)] = false;
+        }
+
+        queue_head[i2c_get_index(i2c)] = transaction->next;
+        if (transaction->next == 0) queue_tail[i2c_get_index(i2c)] = 0;
+
+        transaction->status = (transaction->abort_source != 0) ? i2c_aborted : i2c_done;
+
+        __i2c_start_next(i2c);
+
+        // the callback may submit another transaction, so it is called without holding the lock
+        spinlock_unlock(i2c_lock(i2c_get_index(i2c)));
+        if (transaction->callback != 0) transaction->callback(transaction);
+        return;
+
+    } else if (!dma_active[i2c_get_index(i2c)]) __i2c_fill_tx(i2c, transaction);
+
+    spinlock_unlock(i2c_lock(i2c_get_index(i2c)));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// triggered when the TX FIFO runs low, when the RX FIFO fills up, when a stop condition is detected or when a transfer is aborted
+void I2C0_Handler() {
+
+    i2c_handler(I2C0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// triggered when the TX FIFO runs low, when the RX FIFO fills up, when a stop condition is detected or when a transfer is aborted
+void I2C1_Handler() {
+
+    i2c_handler(I2C1);
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "hal/interp.h"
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// maps each sample through a table of 16-bit entries: output = table[(input >> index_lsb) & ((1 << index_bits) - 1)]
+void interp_lut_u16(const uint16_t *input, uint16_t *output, uint32_t len, const uint16_t *table, uint8_t index_lsb, uint8_t index_bits) {
+
+    // lane 0 produces the byte offset of the entry (index * 2) added to the table address; the lanes can only shift right,
+    // so an index starting at bit 0 is moved up by one bit in software
+    uint8_t pre_shift = (index_lsb == 0) ? 1 : 0;
+
+    interp_lane_configure(INTERP0, 0, index_lsb + pre_shift - 1, 1, index_bits, 0);
+    INTERP0->BASE0 = (uint32_t)table;
+
+    for (uint32_t i = 0; i < len; i++) {
+
+        INTERP0->ACCUM0 = (uint32_t)input[i] << pre_shift;
+        output[i] = *(const uint16_t*)INTERP0->PEEK_LANE0;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// blends two signed 16-bit signals: output = a + (b - a) * alpha / 256
+void interp_blend_s16(const int16_t *a, const int16_t *b, int16_t *output, uint32_t len, uint8_t alpha) {
+
+    // lane 0 enables the blend mode; lane 1 returns the signed blend of BASE0 and BASE1 by the 8 LSBs of its own shift and mask value
+    interp_lane_configure(INTERP0, 0, 0, 0, 31, SIO_INTERP_CTRL_LANE_BLEND);
+    interp_lane_configure(INTERP0, 1, 0, 0, 7, SIO_INTERP_CTRL_LANE_SIGNED);
+    INTERP0->ACCUM1 = alpha;
+
+    for (uint32_t i = 0; i < len; i++) {
+
+        INTERP0->BASE0 = a[i];
+        INTERP0->BASE1 = b[i];
+        output[i] = INTERP0->PEEK_LANE1;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// resamples a signed 16-bit signal with linear interpolation; position and step are 16.16 fixed point sample indices.
+// The source must contain the sample following the last position read. Returns the position following the last output sample
+uint32_t interp_resample_s16(const int16_t *input, int16_t *output, uint32_t len, uint32_t position, uint32_t step) {
+
+    // lane 0 enables the blend mode; lane 1 extracts the top 8 bits of the fraction as alpha and blends the two neighbouring samples
+    interp_lane_configure(INTERP0, 0, 0, 0, 31, SIO_INTERP_CTRL_LANE_BLEND);
+    interp_lane_configure(INTERP0, 1, 8, 0, 7, SIO_INTERP_CTRL_LANE_SIGNED);
+    INTERP0->ACCUM1 = position;
+
+    for (uint32_t i = 0; i < len; i++) {
+
+        const int16_t *sample = &input[INTERP0->ACCUM1 >> 16];
+
+        INTERP0->BASE0 = sample[0];
+        INTERP0->BASE1 = sample[1];
+        output[i] = INTERP0->PEEK_LANE1;
+
+        INTERP0->ACCUM1_ADD = step;
+    }
+
+    return (INTERP0->ACCUM1);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// scales signed fixed-point samples by an arithmetic right shift and saturates the result: output = clamp(input >> shift, min, max)
+void interp_scale_s32(const int32_t *input, int32_t *output, uint32_t len, uint8_t shift, int32_t min, int32_t max) {
+
+    // the clamp mode of INTERP1 lane 0 limits the sign-extended shift result to BASE0 ... BASE1
+    interp_lane_configure(INTERP1, 0, shift, 0, 31 - shift, SIO_INTERP_CTRL_LANE_SIGNED | SIO_INTERP_CTRL_LANE_CLAMP);
+    INTERP1->BASE0 = min;
+    INTERP1->BASE1 = max;
+
+    for (uint32_t i = 0; i < len; i++) {
+
+        INTERP1->ACCUM0 = input[i];
+        output[i] = INTERP1->PEEK_LANE0;
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// samples a texture of 8-bit texels (2^width_bits x 2^height_bits, row major) along a span; u, v, du and dv are 16.16 fixed point
+// texel coordinates, the coordinates wrap around the texture edges
+void interp_texture_span_u8(const uint8_t *texture, uint8_t width_bits, uint8_t height_bits, uint32_t u, uint32_t v, int32_t du, int32_t dv, uint8_t *output, uint32_t len) {
+
+    // lane 0 extracts the column, lane 1 the row already multiplied by the width; both accumulators step by BASE0 / BASE1 on every POP
+    // (ADD_RAW) and the full result adds the texture address from BASE2
+    interp_lane_configure(INTERP0, 0, 16, 0, width_bits - 1, SIO_INTERP_CTRL_LANE_ADD_RAW);
+    interp_lane_configure(INTERP0, 1, 16 - width_bits, width_bits, width_bits + height_bits - 1, SIO_INTERP_CTRL_LANE_ADD_RAW);
+
+    INTERP0->ACCUM0 = u;
+    INTERP0->ACCUM1 = v;
+    INTERP0->BASE0 = du;
+    INTERP0->BASE1 = dv;
+    INTERP0->BASE2 = (uint32_t)texture;
+
+    for (uint32_t i = 0; i < len; i++) output[i] = *(const uint8_t*)INTERP0->POP_FULL;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
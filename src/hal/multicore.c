@@ -0,0 +1,124 @@
+#include "hal/multicore.h"
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static multicore_fifo_callback_t fifo_callback[2] = {0};   // FIFO receive callbacks of the cores
+static void (* volatile core1_entry)(void) = 0;            // entry function of core 1
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// first code executed by core 1; the bootrom branches here, so there is no valid return address
+static void __attribute__((noreturn)) __multicore_core1_trampoline(void) {
+
+    core1_entry();
+
+    while (1) __WFE();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// passes the received words to the callback of the core
+static force_inline void __multicore_fifo_handler(uint8_t core) {
+
+    multicore_fifo_clear_errors();
+
+    uint32_t data;
+    while (multicore_fifo_try_pop(&data)) {
+
+        if (fifo_callback[core] != 0) fifo_callback[core](data);
+    }
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// resets core 1 and starts it at the entry function with the stack in SRAM4; must be called from core 0. Core 1 sleeps if the entry function returns
+void multicore_launch_core1(void (*entry)(void)) {
+
+    multicore_launch_core1_with_stack(entry, MULTICORE_CORE1_STACK_TOP);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// resets core 1 and starts it at the entry function with the specified stack; stack_top is the address just above the stack (8-byte aligned)
+void multicore_launch_core1_with_stack(void (*entry)(void), uint32_t *stack_top) {
+
+    multicore_reset_core1();
+    core1_entry = entry;
+
+    // the FIFO interrupt handler of core 0 would consume the replies of the bootrom
+    bool irq_enabled = bit_is_set(NVIC->ISER[0], (1 << SIO_PROC_IRQ0));
+    NVIC_DisableIRQ(SIO_PROC_IRQ0);
+
+    // launch sequence of the core 1 bootrom; the bootrom echoes every word and restarts the sequence on a mismatch
+    const uint32_t sequence[] = {0, 0, 1, SCB->VTOR, (uint32_t)stack_top, (uint32_t)__multicore_core1_trampoline};
+    uint8_t index = 0;
+
+    while (index < sizeof(sequence) / sizeof(sequence[0])) {
+
+        uint32_t command = sequence[index];
+
+        // a zero resynchronizes the bootrom; discard any stale replies before sending it
+        if (command == 0) {
+
+            multicore_fifo_drain();
+            __SEV();
+        }
+
+        multicore_fifo_push_blocking(command);
+        uint32_t response = multicore_fifo_pop_blocking();
+
+        index = (response == command) ? index + 1 : 0;
+    }
+
+    multicore_fifo_clear_errors();
+    if (irq_enabled) NVIC_EnableIRQ(SIO_PROC_IRQ0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// holds core 1 in reset; it can be started again by multicore_launch_core1()
+void multicore_reset_core1(void) {
+
+    atomic_set_bits(PSM->FRCE_OFF, PSM_PROC1);
+    while (bit_is_clear(PSM->FRCE_OFF, PSM_PROC1));
+    atomic_clear_bits(PSM->FRCE_OFF, PSM_PROC1);
+
+    // the zero pushed by the core 1 bootrom after reset is discarded by the launch sequence
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the callback for the words received by the calling core and enables its SIO_PROC interrupt; passing 0 disables the interrupt
+void multicore_fifo_set_callback(multicore_fifo_callback_t callback) {
+
+    uint8_t core = multicore_get_core_num();
+    IRQn_Type irq = core ? SIO_PROC_IRQ1 : SIO_PROC_IRQ0;
+
+    NVIC_DisableIRQ(irq);
+    fifo_callback[core] = callback;
+
+    if (callback != 0) {
+
+        multicore_fifo_clear_errors();
+        NVIC_SetPriority(irq, 0);
+        NVIC_EnableIRQ(irq);
+    }
+}
+
+//---- IRQ HANDLERS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// triggered on core 0 when its RX FIFO is not empty or on a FIFO error
+void SIO_Proc0_Handler() {
+
+    __multicore_fifo_handler(0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// triggered on core 1 when its RX FIFO is not empty or on a FIFO error
+void SIO_Proc1_Handler() {
+
+    __multicore_fifo_handler(1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
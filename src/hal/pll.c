@@ -13,17 +13,54 @@ void pll_init(PLL_t *pll, uint16_t vco_fbdiv, uint8_t post_div1, uint8_t post_di
     pll->FBDIV_INT = vco_fbdiv;     // set VCO feedback divider
 
 	// enable power for PLL and VCO
-    clear_bits(pll->PWR, PLL_PWR_PD | PLL_PWR_VCOPD);
+    atomic_clear_bits(pll->PWR, PLL_PWR_PD | PLL_PWR_VCOPD);
 
     // wait for the PLL to lock
 	while (bit_is_clear(pll->CS, PLL_CS_LOCK));
 
     // set PLL post dividers
-	write_masked(pll->PRIM, post_div1, PLL_PRIM_POSTDIV1_MASK, PLL_PRIM_POSTDIV1_LSB);
-	write_masked(pll->PRIM, post_div2, PLL_PRIM_POSTDIV2_MASK, PLL_PRIM_POSTDIV2_LSB);
+	atomic_write_masked(pll->PRIM, post_div1, PLL_PRIM_POSTDIV1_MASK, PLL_PRIM_POSTDIV1_LSB);
+	atomic_write_masked(pll->PRIM, post_div2, PLL_PRIM_POSTDIV2_MASK, PLL_PRIM_POSTDIV2_LSB);
 
 	// enable power for post dividers
-    clear_bits(pll->PWR, PLL_PWR_POSTDIVPD);
+    atomic_clear_bits(pll->PWR, PLL_PWR_POSTDIVPD);
 }  
 
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// finds the PLL settings producing the frequency closest to target_hz (the lowest VCO frequency among equally close settings, to save power);
+// does not access the hardware. Returns false if no settings within the VCO range exist
+bool pll_plan(uint32_t ref_hz, uint32_t target_hz, pll_config_t *config) {
+
+    uint32_t best_error = 0xffffffff;
+
+    for (uint16_t fbdiv = PLL_FBDIV_MIN; fbdiv <= PLL_FBDIV_MAX; fbdiv++) {
+
+        uint64_t vco_hz = (uint64_t)ref_hz * fbdiv;
+        if (vco_hz < PLL_VCO_MIN_HZ) continue;
+        if (vco_hz > PLL_VCO_MAX_HZ) break;
+
+        for (uint8_t postdiv1 = 1; postdiv1 <= PLL_POSTDIV_MAX; postdiv1++) {
+
+            // postdiv2 <= postdiv1 covers all the products; a higher first divider saves power
+            for (uint8_t postdiv2 = 1; postdiv2 <= postdiv1; postdiv2++) {
+
+                uint32_t out_hz = vco_hz / (postdiv1 * postdiv2);
+                uint32_t error = (out_hz > target_hz) ? (out_hz - target_hz) : (target_hz - out_hz);
+
+                // the VCO frequency only grows, so an equal error never replaces the lower VCO found earlier
+                if (error < best_error) {
+
+                    best_error = error;
+                    config->fbdiv = fbdiv;
+                    config->postdiv1 = postdiv1;
+                    config->postdiv2 = postdiv2;
+                }
+            }
+        }
+    }
+
+    return (best_error != 0xffffffff);
+}
+
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+#include "hal/rom.h"
+#include "hal/divider.h"
+#include "registers/address_map.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define ROM_FUNC_TABLE_PTR      (ROM_BASE + 0x14)       // 16-bit pointer to the public function table
+#define ROM_DATA_TABLE_PTR      (ROM_BASE + 0x16)       // 16-bit pointer to the public data table
+#define ROM_TABLE_LOOKUP_PTR    (ROM_BASE + 0x18)       // 16-bit pointer to the table lookup function
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// looks up a code in a ROM table; returns 0 if the code is not found
+typedef void *(*rom_table_lookup_t)(const uint16_t *table, uint32_t code);
+
+rom_table_t rom_table = {0};
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the 16-bit address stored in the ROM as a pointer
+#define rom_hword_as_ptr(address) ((void*)(uint32_t)(*(const uint16_t*)(address)))
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// resolves the ROM functions into rom_table; called by the startup code before main
+void rom_init(void) {
+
+    rom_table.popcount32 = rom_func_lookup(ROM_TABLE_CODE('P', '3'));
+    rom_table.reverse32 = rom_func_lookup(ROM_TABLE_CODE('R', '3'));
+    rom_table.clz32 = rom_func_lookup(ROM_TABLE_CODE('L', '3'));
+    rom_table.ctz32 = rom_func_lookup(ROM_TABLE_CODE('T', '3'));
+    rom_table.memset = rom_func_lookup(ROM_TABLE_CODE('M', 'S'));
+    rom_table.memset4 = rom_func_lookup(ROM_TABLE_CODE('S', '4'));
+    rom_table.memcpy = rom_func_lookup(ROM_TABLE_CODE('M', 'C'));
+    rom_table.memcpy44 = rom_func_lookup(ROM_TABLE_CODE('C', '4'));
+
+    rom_table.soft_float = rom_data_lookup(ROM_TABLE_CODE('S', 'F'));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the address of the ROM function with the code or 0 if the ROM does not provide it
+void *rom_func_lookup(uint32_t code) {
+
+    rom_table_lookup_t lookup = (rom_table_lookup_t)rom_hword_as_ptr(ROM_TABLE_LOOKUP_PTR);
+    return lookup((const uint16_t*)rom_hword_as_ptr(ROM_FUNC_TABLE_PTR), code);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the address of the ROM data with the code or 0 if the ROM does not provide it
+void *rom_data_lookup(uint32_t code) {
+
+    rom_table_lookup_t lookup = (rom_table_lookup_t)rom_hword_as_ptr(ROM_TABLE_LOOKUP_PTR);
+    return lookup((const uint16_t*)rom_hword_as_ptr(ROM_DATA_TABLE_PTR), code);
+}
+
+//---- FLOAT HELPERS ---------------------------------------------------------------------------------------------------------------------------------------------
+
+#if ROM_FLOAT
+
+// the ROM functions take and return floats in the core registers, like the soft-float ABI of the compiler helpers
+
+float __aeabi_fadd(float a, float b) {return rom_table.soft_float->fadd(a, b);}
+
+float __aeabi_fsub(float a, float b) {return rom_table.soft_float->fsub(a, b);}
+
+float __aeabi_frsub(float a, float b) {return rom_table.soft_float->fsub(b, a);}
+
+float __aeabi_fmul(float a, float b) {return rom_table.soft_float->fmul(a, b);}
+
+float __aeabi_i2f(int32_t a) {return rom_table.soft_float->int2float(a);}
+
+float __aeabi_ui2f(uint32_t a) {return rom_table.soft_float->uint2float(a);}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// the ROM division uses the hardware divider without saving its state; keep the state of an interrupted division
+float __aeabi_fdiv(float a, float b) {
+
+    if (!divider_is_dirty()) return rom_table.soft_float->fdiv(a, b);
+
+    divider_state_t saved;
+    divider_save_state(&saved);
+    float result = rom_table.soft_float->fdiv(a, b);
+    divider_restore_state(&saved);
+
+    return result;
+}
+
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -1,17 +1,225 @@
 #include "hal/spi.h"
 #include "hal/resets.h"
 #include "hal/clocks.h"
-#include "hal/fc0.h"
+#include "hal/dma.h"
+#include "hal/dfs.h"
+#include "hal/timer.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define SPI_FIFO_DEPTH      8       // depth of the hardware TX and RX FIFOs
+#define SPI_DMA_SINK_COUNT  0xffffffff  // transfer count of the RX DMA while streaming; the received data is discarded
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static int8_t tx_dma_channel[2] = {-1, -1};         // DMA channel feeding the TX FIFO; -1 if the DMA mode is disabled
+static int8_t rx_dma_channel[2] = {-1, -1};         // DMA channel draining the RX FIFO
+static int8_t chain_dma_channel[2] = {-1, -1};      // second TX channel of a chained stream; -1 if not streaming in chained mode
+
+static volatile bool dma_busy[2] = {false};         // a DMA transfer is in progress
+static volatile bool streaming[2] = {false};        // a stream is in progress
+static spi_callback_t dma_callback[2] = {0};        // completion callback of the transfer or stream
+
+static const void *stream_buffer[2][2];             // buffers of the stream
+static uint32_t stream_len[2];                      // length of the stream buffers [frames]
+static volatile uint8_t stream_next[2];             // buffer to be sent after the one in progress (non-chained mode)
+static bool stream_ring[2] = {false};               // the buffers of a chained stream are rearmed by the read ring of the DMA instead of the DMA IRQ
+
+static uint32_t spi_baudrate[2] = {0};              // baud rate of the initialized SPIs; 0 if the SPI is not initialized
+
+static uint32_t dma_zero = 0;                       // source of the transmitted data if there is no TX buffer
+static uint32_t dma_sink[2];                        // destination of the received data if there is no RX buffer
+
+// returns 0 if argument is SPI0; returns 1 if argument is SPI1
+#define spi_get_index(spi) (spi == SPI1)
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the DMA control register value for the TX or RX channel of the SPI; the transfer size follows the data width of the SPI
+static uint32_t __spi_dma_ctrl(SPI_t *spi, bool tx) {
+
+    bool wide = ((spi->SSPCR0 & SPI_SSPCR0_DSS_MASK) >> SPI_SSPCR0_DSS_LSB) > 7;
+    uint32_t dreq = spi_get_index(spi) ? (tx ? DMA_DREQ_SPI1_TX : DMA_DREQ_SPI1_RX) : (tx ? DMA_DREQ_SPI0_TX : DMA_DREQ_SPI0_RX);
+
+    return (DMA_CTRL_EN | (wide ? DMA_CTRL_DATA_SIZE_VAL_HALFWORD : DMA_CTRL_DATA_SIZE_VAL_BYTE) | (dreq << DMA_CTRL_TREQ_SEL_LSB));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// discards data left in the RX FIFO and clears the overrun flag
+static void __spi_flush_rx(SPI_t *spi) {
+
+    while (spi_rx_not_empty(spi)) (void)spi_read(spi);
+    spi->SSPICR = SPI_SSPICR_RORIC;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the read ring size of the DMA for a stream buffer (log2 of its size in bytes) if the buffer is a power of two of at most 32 kB
+// aligned to its size; 0 otherwise
+static uint8_t __spi_ring_bits(const void *buffer, uint32_t size) {
+
+    if (size < 2 || size > 32768 || (size & (size - 1)) != 0 || ((uint32_t)buffer & (size - 1)) != 0) return 0;
+
+    uint8_t bits = 0;
+    while ((1UL << bits) < size) bits++;
+
+    return bits;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called from the DMA IRQ when the RX channel has received the last frame of a transfer
+static void __spi_rx_dma_complete(uint8_t channel) {
+
+    uint8_t index = (channel == rx_dma_channel[1]);
+    SPI_t *spi = index ? SPI1 : SPI0;
+
+    // the discarding RX channel of a stream has run out; keep it going
+    if (streaming[index]) {
+
+        DMA->CH[channel].AL1_TRANS_COUNT_TRIG = SPI_DMA_SINK_COUNT;
+        return;
+    }
+
+    dma_busy[index] = false;
+    if (dma_callback[index] != 0) dma_callback[index](spi, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called from the DMA IRQ when a buffer of a stream has been sent
+static void __spi_stream_complete(uint8_t channel) {
+
+    uint8_t index = (channel == tx_dma_channel[1] || channel == chain_dma_channel[1]);
+    SPI_t *spi = index ? SPI1 : SPI0;
+    uint8_t buffer;
+
+    if (!streaming[index]) return;
+
+    // chained mode: the other channel has already been started by the hardware. The transfer count reloads on every trigger; the read address
+    // has been wrapped back to the buffer by the read ring, otherwise this channel is rearmed here without triggering it
+    if (chain_dma_channel[index] >= 0) {
+
+        buffer = (channel == chain_dma_channel[index]);
+
+        if (!stream_ring[index]) {
+
+            // the other buffer has been sent as well and has retriggered this channel before the IRQ got here; it is sending the memory behind its buffer
+            if (dma_channel_busy(channel)) {
+
+                spi_stream_stop(spi);
+                return;
+            }
+
+            DMA->CH[channel].READ_ADDR = (uint32_t)stream_buffer[index][buffer];
+        }
+
+    // single channel mode: start the other buffer
+    } else {
+
+        buffer = stream_next[index] ^ 1;
+        dma_channel_transfer_from(channel, stream_buffer[index][stream_next[index]], stream_len[index]);
+        stream_next[index] = buffer;
+    }
+
+    if (dma_callback[index] != 0) dma_callback[index](spi, buffer);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called by the DFS service around a clk_peri change; the DMA transfers and streams are paused and the frames in the TX FIFO are clocked out
+// before the change, and resumed after the clock divisors of the initialized SPIs have been recalculated
+static void __spi_clock_changed(enum dfs_event event, uint32_t clk_sys_hz) {
+
+    (void)clk_sys_hz;
+
+    for (uint8_t index = 0; index < 2; index++) {
+
+        SPI_t *spi = index ? SPI1 : SPI0;
+        if (spi_baudrate[index] == 0) continue;
+
+        if (event == dfs_pre_change) {
+
+            // the TX channel waits for its DREQ and continues after the change; the RX channel collects the frames still in flight
+            if (tx_dma_channel[index] >= 0) atomic_clear_bits(spi->SSPDMACR, SPI_SSPDMACR_TXDMAE);
+
+            // the TX FIFO and the shift register empty within FIFO depth + 1 frames of up to 16 bits
+            uint64_t deadline = timer_get_us() + (SPI_FIFO_DEPTH + 1) * 16 * 1000000UL / spi_baudrate[index] + 1;
+            while (!spi_tx_done(spi) && timer_get_us() < deadline);
+
+        } else {
+
+            spi_set_baudrate(spi, spi_baudrate[index]);
+            if (tx_dma_channel[index] >= 0) atomic_set_bits(spi->SSPDMACR, SPI_SSPDMACR_TXDMAE);
+        }
+    }
+}
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the SPI block
+// initializes the SPI block; an SPI that is already initialized is deinitialized first
 void spi_init(SPI_t *spi, uint32_t baudrate_hz, uint8_t data_width) {
 
-    resets_reset_block((spi == SPI0) ? RESETS_SPI0 : RESETS_SPI1);
+    spi_deinit(spi);
     resets_unreset_block((spi == SPI0) ? RESETS_SPI0 : RESETS_SPI1);
+    dfs_register_notifier(__spi_clock_changed);
+
+    spi_set_baudrate(spi, baudrate_hz);
+
+    atomic_write_masked(spi->SSPCR0, data_width - 1, SPI_SSPCR0_DSS_MASK, SPI_SSPCR0_DSS_LSB);     // data width
+    atomic_clear_bits(spi->SSPCR0, SPI_SSPCR0_SPO);    // SPI clock polarity
+    atomic_clear_bits(spi->SSPCR0, SPI_SSPCR0_SPH);    // SPI clock phase
+    atomic_set_bits(spi->SSPCR1, SPI_SSPCR1_SSE);      // SPI enable
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// deinitializes the SPI block; a DMA transfer or stream in progress is aborted without calling its callback and the DMA channels are released
+void spi_deinit(SPI_t *spi) {
+
+    uint8_t index = spi_get_index(spi);
+
+    streaming[index] = false;
+    dma_busy[index] = false;
+    dma_callback[index] = 0;
+
+    if (tx_dma_channel[index] >= 0) {
+
+        // stop the DMA requests (the block is out of reset in DMA mode) and break the chain, so an aborted channel cannot trigger the other one
+        atomic_clear_bits(spi->SSPDMACR, SPI_SSPDMACR_TXDMAE | SPI_SSPDMACR_RXDMAE);
+
+        if (chain_dma_channel[index] >= 0) {
+
+            dma_channel_chain_to(tx_dma_channel[index], tx_dma_channel[index]);
+            dma_channel_chain_to(chain_dma_channel[index], chain_dma_channel[index]);
+            dma_channel_unclaim(chain_dma_channel[index]);
+            chain_dma_channel[index] = -1;
+        }
+
+        dma_channel_unclaim(tx_dma_channel[index]);
+        dma_channel_unclaim(rx_dma_channel[index]);
+        tx_dma_channel[index] = -1;
+        rx_dma_channel[index] = -1;
+    }
+
+    stream_buffer[index][0] = 0;
+    stream_buffer[index][1] = 0;
+    stream_len[index] = 0;
+    stream_ring[index] = false;
 
-    uint32_t freq_in = fc0_get_hz(fc0_clk_peri);        // get a peripheral clock frequency
+    resets_reset_block((spi == SPI0) ? RESETS_SPI0 : RESETS_SPI1);
+    spi_baudrate[index] = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the baud rate according to the current clk_peri frequency; called automatically when the DFS service changes the clocks
+void spi_set_baudrate(SPI_t *spi, uint32_t baudrate_hz) {
+
+    spi_baudrate[spi_get_index(spi)] = baudrate_hz;
+
+    uint32_t freq_in = clocks_get_hz(clk_peri);        // get a peripheral clock frequency
     uint32_t prescale, postdiv;
 
     // calculate the minimum required prescaler to achieve SSPCLK lower than the specified baud rate
@@ -26,13 +234,198 @@ void spi_init(SPI_t *spi, uint32_t baudrate_hz, uint8_t data_width) {
     if (postdiv > 256) postdiv = 256;
     if (postdiv == 0) postdiv = 1;
 
+    // the clock rate must not change while the SSP is enabled
+    uint32_t enabled = spi->SSPCR1 & SPI_SSPCR1_SSE;
+    atomic_clear_bits(spi->SSPCR1, SPI_SSPCR1_SSE);
+
     spi->SSPCPSR = prescale;                                                            // clock prescale divisor
-    write_masked(spi->SSPCR0, postdiv - 1, SPI_SSPCR0_SCR_MASK, SPI_SSPCR0_SCR_LSB);    // serial clock rate
+    atomic_write_masked(spi->SSPCR0, postdiv - 1, SPI_SSPCR0_SCR_MASK, SPI_SSPCR0_SCR_LSB);    // serial clock rate
+
+    atomic_set_bits(spi->SSPCR1, enabled);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// transmits len frames from tx and stores the len received frames to rx while keeping the TX FIFO filled, so the frames are sent back to back;
+// the buffers are uint8_t arrays for data widths up to 8 bits and uint16_t arrays otherwise. tx may be 0 to transmit zeros, rx may be 0 to discard the received data
+void spi_transfer(SPI_t *spi, const void *tx, void *rx, uint32_t len) {
+
+    bool wide = ((spi->SSPCR0 & SPI_SSPCR0_DSS_MASK) >> SPI_SSPCR0_DSS_LSB) > 7;    // DSS holds the data width - 1
+    uint32_t tx_count = 0, rx_count = 0;
+
+    // discard data left in the RX FIFO by previous writes
+    while (spi_rx_not_empty(spi)) (void)spi_read(spi);
+
+    while (rx_count < len) {
+
+        // keep at most SPI_FIFO_DEPTH frames in flight, so the RX FIFO cannot overflow while the TX FIFO is kept full
+        while (tx_count < len && tx_count - rx_count < SPI_FIFO_DEPTH && bit_is_set(spi->SSPSR, SPI_SSPSR_TNF)) {
+
+            uint16_t data = 0;
+            if (tx != 0) data = wide ? ((const uint16_t*)tx)[tx_count] : ((const uint8_t*)tx)[tx_count];
+
+            spi_write(spi, data);
+            tx_count++;
+        }
+
+        while (rx_count < tx_count && spi_rx_not_empty(spi)) {
+
+            uint16_t data = spi_read(spi);
+
+            if (rx != 0) {
+
+                if (wide) ((uint16_t*)rx)[rx_count] = data;
+                else ((uint8_t*)rx)[rx_count] = data;
+            }
+
+            rx_count++;
+        }
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// switches the SPI to DMA mode: transfers are executed by a TX and an RX DMA channel paced by the SSP DREQs;
+// the DMA needs to be initialized first. Returns false if there are not two DMA channels available
+bool spi_enable_dma(SPI_t *spi) {
+
+    uint8_t index = spi_get_index(spi);
+    if (tx_dma_channel[index] >= 0) return true;
+
+    int8_t tx_channel = dma_channel_claim();
+    if (tx_channel < 0) return false;
+
+    int8_t rx_channel = dma_channel_claim();
+    if (rx_channel < 0) {
+
+        dma_channel_unclaim(tx_channel);
+        return false;
+    }
+
+    tx_dma_channel[index] = tx_channel;
+    rx_dma_channel[index] = rx_channel;
+    dma_busy[index] = false;
+    streaming[index] = false;
+
+    dma_channel_set_callback(rx_channel, __spi_rx_dma_complete);
+    atomic_set_bits(spi->SSPDMACR, SPI_SSPDMACR_TXDMAE | SPI_SSPDMACR_RXDMAE);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// starts a DMA transfer of len frames; tx may be 0 to transmit zeros, rx may be 0 to discard the received data. The callback (may be 0) is called
+// when the last frame has been received. Returns false if the DMA mode is not enabled or the DMA is busy
+bool spi_transfer_dma(SPI_t *spi, const void *tx, void *rx, uint32_t len, spi_callback_t callback) {
+
+    uint8_t index = spi_get_index(spi);
+    if (tx_dma_channel[index] < 0 || spi_dma_busy(spi) || len == 0) return false;
+
+    __spi_flush_rx(spi);
+
+    dma_busy[index] = true;
+    dma_callback[index] = callback;
+
+    // the RX channel completes last, so it signals the end of the transfer
+    dma_channel_configure(rx_dma_channel[index], &spi->SSPDR, rx != 0 ? rx : (void*)&dma_sink[index], len, __spi_dma_ctrl(spi, false) | (rx != 0 ? DMA_CTRL_INCR_WRITE : 0));
+    dma_channel_configure(tx_dma_channel[index], tx != 0 ? tx : (const void*)&dma_zero, &spi->SSPDR, len, __spi_dma_ctrl(spi, true) | (tx != 0 ? DMA_CTRL_INCR_READ : 0));
+
+    DMA->MULTI_CHAN_TRIGGER = (1 << rx_dma_channel[index]) | (1 << tx_dma_channel[index]);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true while a DMA transfer or a stream is in progress
+bool spi_dma_busy(SPI_t *spi) {
+
+    return (dma_busy[spi_get_index(spi)] || streaming[spi_get_index(spi)]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// starts streaming two buffers of len frames alternately until spi_stream_stop() is called; the callback is called whenever a buffer has been sent
+// and can be refilled. With chained set, the buffers follow each other without a gap (needs one more DMA channel); otherwise the next buffer is started
+// from the DMA IRQ. Received data is discarded. Returns false if the DMA mode is not enabled, the DMA is busy or no DMA channel is available
+bool spi_stream_start(SPI_t *spi, const void *buffer_0, const void *buffer_1, uint32_t len, bool chained, spi_callback_t callback) {
+
+    uint8_t index = spi_get_index(spi);
+    if (tx_dma_channel[index] < 0 || spi_dma_busy(spi) || len == 0) return false;
+
+    if (chained) {
+
+        int8_t channel = dma_channel_claim();
+        if (channel < 0) return false;
+        chain_dma_channel[index] = channel;
+    }
+
+    __spi_flush_rx(spi);
+
+    stream_buffer[index][0] = buffer_0;
+    stream_buffer[index][1] = buffer_1;
+    stream_len[index] = len;
+    stream_next[index] = 1;
+    dma_callback[index] = callback;
+    streaming[index] = true;
+
+    uint32_t tx_ctrl = __spi_dma_ctrl(spi, true) | DMA_CTRL_INCR_READ;
+    uint32_t size = len * ((tx_ctrl & DMA_CTRL_DATA_SIZE_MASK) == DMA_CTRL_DATA_SIZE_VAL_HALFWORD ? 2 : 1);
+    uint8_t ring_bits[2] = {__spi_ring_bits(buffer_0, size), __spi_ring_bits(buffer_1, size)};
+    stream_ring[index] = (chained && ring_bits[0] != 0 && ring_bits[1] != 0);
+    uint32_t trigger = (1 << rx_dma_channel[index]) | (1 << tx_dma_channel[index]);
+
+    // the received data is discarded into a single word
+    dma_channel_configure(rx_dma_channel[index], &spi->SSPDR, &dma_sink[index], SPI_DMA_SINK_COUNT, __spi_dma_ctrl(spi, false));
+    dma_channel_configure(tx_dma_channel[index], buffer_0, &spi->SSPDR, len, tx_ctrl | (stream_ring[index] ? (ring_bits[0] << DMA_CTRL_RING_SIZE_LSB) : 0));
+    dma_channel_set_callback(tx_dma_channel[index], __spi_stream_complete);
+
+    // the channels trigger each other when they complete
+    if (chained) {
+
+        dma_channel_configure(chain_dma_channel[index], buffer_1, &spi->SSPDR, len, tx_ctrl | (stream_ring[index] ? (ring_bits[1] << DMA_CTRL_RING_SIZE_LSB) : 0));
+        dma_channel_chain_to(tx_dma_channel[index], chain_dma_channel[index]);
+        dma_channel_chain_to(chain_dma_channel[index], tx_dma_channel[index]);
+        dma_channel_set_callback(chain_dma_channel[index], __spi_stream_complete);
+    }
+
+    DMA->MULTI_CHAN_TRIGGER = trigger;
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// stops streaming; the frame being sent is finished
+void spi_stream_stop(SPI_t *spi) {
+
+    uint8_t index = spi_get_index(spi);
+    if (!streaming[index]) return;
+
+    streaming[index] = false;
+
+    // break the chain first, so the aborted channel cannot trigger the other one
+    if (chain_dma_channel[index] >= 0) {
+
+        dma_channel_chain_to(tx_dma_channel[index], tx_dma_channel[index]);
+        dma_channel_chain_to(chain_dma_channel[index], chain_dma_channel[index]);
+        dma_channel_abort(chain_dma_channel[index]);
+        dma_channel_unclaim(chain_dma_channel[index]);
+        chain_dma_channel[index] = -1;
+    }
+
+    dma_channel_set_callback(tx_dma_channel[index], 0);
+    dma_channel_abort(tx_dma_channel[index]);
+
+    while (!spi_tx_done(spi));
+
+    // an aborted channel may raise its completion interrupt (RP2040-E13); mask it while aborting
+    dma_channel_set_callback(rx_dma_channel[index], 0);
+    dma_channel_abort(rx_dma_channel[index]);
+    dma_channel_set_callback(rx_dma_channel[index], __spi_rx_dma_complete);
 
-    write_masked(spi->SSPCR0, data_width - 1, SPI_SSPCR0_DSS_MASK, SPI_SSPCR0_DSS_LSB);     // data width
-    clear_bits(spi->SSPCR0, SPI_SSPCR0_SPO);    // SPI clock polarity
-    clear_bits(spi->SSPCR0, SPI_SSPCR0_SPH);    // SPI clock phase
-    set_bits(spi->SSPCR1, SPI_SSPCR1_SSE);      // SPI enable
+    __spi_flush_rx(spi);
 }
 
 //----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,68 @@
+#include "hal/spinlock.h"
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint32_t claimed_locks = (1UL << spinlock_id_first_free) - 1;      // bit mask of locks in use; the driver locks are always in use
+
+#if SPINLOCK_STATS
+spinlock_stats_t spinlock_stats[SPINLOCK_COUNT] = {0};
+#endif
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// claims an unused spinlock; returns the lock number or -1 if all locks are in use
+int8_t spinlock_claim(void) {
+
+    int8_t claimed = -1;
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_claim);
+
+    for (uint8_t lock = spinlock_id_first_free; lock < SPINLOCK_COUNT; lock++) {
+
+        if (bit_is_clear(claimed_locks, (1UL << lock))) {
+
+            set_bits(claimed_locks, (1UL << lock));
+            claimed = lock;
+            break;
+        }
+    }
+
+    spinlock_unlock_irqrestore(spinlock_id_claim, primask);
+
+    return claimed;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// releases a claimed spinlock
+void spinlock_unclaim(uint8_t lock) {
+
+    if (lock < spinlock_id_first_free) return;
+
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_claim);
+    clear_bits(claimed_locks, (1UL << lock));
+    spinlock_unlock_irqrestore(spinlock_id_claim, primask);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the acquisition counters of the lock
+spinlock_stats_t spinlock_get_stats(uint8_t lock) {
+
+#if SPINLOCK_STATS
+    return (spinlock_stats[lock]);
+#else
+    return ((spinlock_stats_t){0});
+#endif
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// resets the acquisition counters of all locks
+void spinlock_reset_stats(void) {
+
+#if SPINLOCK_STATS
+    for (uint8_t lock = 0; lock < SPINLOCK_COUNT; lock++) spinlock_stats[lock] = (spinlock_stats_t){0};
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
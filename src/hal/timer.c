@@ -0,0 +1,208 @@
+#include "hal/timer.h"
+#include "hal/spinlock.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define ALARM_MAX_DELAY     0x7fffffff      // the alarm matches the lower 32 bits of the counter; later deadlines are reached in steps
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static soft_timer_t *heap[SOFT_TIMER_MAX];      // armed timers; binary min-heap ordered by deadline
+static uint16_t heap_size = 0;                  // number of armed timers
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// places the timer to the position in the heap
+static force_inline void __heap_set(uint16_t index, soft_timer_t *timer) {
+
+    heap[index] = timer;
+    timer->heap_slot = index + 1;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// moves the timer at the position towards the root until its parent expires earlier
+static void __heap_sift_up(uint16_t index) {
+
+    soft_timer_t *timer = heap[index];
+
+    while (index > 0) {
+
+        uint16_t parent = (index - 1) / 2;
+        if (heap[parent]->deadline <= timer->deadline) break;
+
+        __heap_set(index, heap[parent]);
+        index = parent;
+    }
+
+    __heap_set(index, timer);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// moves the timer at the position towards the leaves until both its children expire later
+static void __heap_sift_down(uint16_t index) {
+
+    soft_timer_t *timer = heap[index];
+
+    while (1) {
+
+        uint16_t child = 2 * index + 1;
+        if (child >= heap_size) break;
+
+        if (child + 1 < heap_size && heap[child + 1]->deadline < heap[child]->deadline) child++;
+        if (timer->deadline <= heap[child]->deadline) break;
+
+        __heap_set(index, heap[child]);
+        index = child;
+    }
+
+    __heap_set(index, timer);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// adds an unarmed timer to the heap; the heap must not be full
+static void __heap_insert(soft_timer_t *timer) {
+
+    __heap_set(heap_size, timer);
+    __heap_sift_up(heap_size++);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// removes an armed timer from the heap; the last timer takes its place and is moved up or down to restore the order
+static void __heap_remove(soft_timer_t *timer) {
+
+    uint16_t index = timer->heap_slot - 1;
+    timer->heap_slot = 0;
+
+    if (--heap_size == index) return;
+
+    __heap_set(index, heap[heap_size]);
+
+    if (index > 0 && heap[index]->deadline < heap[(index - 1) / 2]->deadline) __heap_sift_up(index);
+    else __heap_sift_down(index);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// programs alarm 0 to the earliest deadline; disarms it if no timer is armed
+static void __alarm_update(void) {
+
+    if (heap_size == 0) {
+
+        TIMER->ARMED = TIMER_INT_ALARM0;        // writing 1 disarms the alarm
+        return;
+    }
+
+    uint64_t deadline = heap[0]->deadline;
+    uint64_t now = timer_get_us();
+
+    if (deadline > now + ALARM_MAX_DELAY) deadline = now + ALARM_MAX_DELAY;
+    TIMER->ALARM[0] = (uint32_t)deadline;
+
+    // the deadline may have passed before the alarm was armed, in which case the alarm would only fire after the counter wraps
+    // the IRQ is forced in the TIMER rather than pended in the NVIC, which only reaches the calling core
+    if (timer_get_us() >= deadline) atomic_set_bits(TIMER->INTF, TIMER_INT_ALARM0);
+}
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// initializes the software timer service on alarm 0; Watchdog tick needs to be initialized first
+void soft_timer_init(void) {
+
+    heap_size = 0;
+
+    TIMER->ARMED = TIMER_INT_ALARM0;
+    TIMER->INTR = TIMER_INT_ALARM0;
+    atomic_set_bits(TIMER->INTE, TIMER_INT_ALARM0);
+
+    NVIC_EnableIRQ(TIMER_IRQ0);
+    NVIC_SetPriority(TIMER_IRQ0, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// arms the timer to expire after delay_us and then every period_us (0 for a one-shot timer); an armed timer is restarted.
+// Returns false if SOFT_TIMER_MAX timers are armed already
+bool soft_timer_start(soft_timer_t *timer, uint32_t delay_us, uint32_t period_us, soft_timer_callback_t callback) {
+
+    bool started = false;
+
+    // the alarm IRQ modifies the heap as well; the timers may be started from both cores
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_soft_timer);
+
+    if (soft_timer_is_active(timer)) __heap_remove(timer);
+
+    if (heap_size < SOFT_TIMER_MAX) {
+
+        timer->deadline = timer_get_us() + delay_us;
+        timer->period = period_us;
+        timer->callback = callback;
+
+        __heap_insert(timer);
+        if (heap[0] == timer) __alarm_update();
+
+        started = true;
+    }
+
+    spinlock_unlock_irqrestore(spinlock_id_soft_timer, primask);
+
+    return started;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// disarms the timer; does nothing if the timer is not armed
+void soft_timer_cancel(soft_timer_t *timer) {
+
+    uint32_t primask = spinlock_lock_irqsave(spinlock_id_soft_timer);
+
+    if (soft_timer_is_active(timer)) {
+
+        bool was_first = (heap[0] == timer);
+
+        __heap_remove(timer);
+        if (was_first) __alarm_update();
+    }
+
+    spinlock_unlock_irqrestore(spinlock_id_soft_timer, primask);
+}
+
+//---- IRQ HANDLERS ----------------------------------------------------------------------------------------------------------------------------------------------
+
+// triggered when the counter reaches the earliest deadline
+void Timer0_Handler() {
+
+    TIMER->INTR = TIMER_INT_ALARM0;     // acknowledge the IRQ
+    atomic_clear_bits(TIMER->INTF, TIMER_INT_ALARM0);
+
+    uint64_t now = timer_get_us();
+
+    spinlock_lock(spinlock_id_soft_timer);
+
+    for (uint8_t expired = 0; expired < SOFT_TIMER_MAX_EXPIRIES && heap_size > 0 && heap[0]->deadline <= now; expired++) {
+
+        soft_timer_t *timer = heap[0];
+        __heap_remove(timer);
+
+        // periodic timers are rearmed before the callback, so the callback can cancel them; the period does not drift with the IRQ latency
+        if (timer->period != 0) {
+
+            timer->deadline += timer->period;
+            __heap_insert(timer);
+        }
+
+        // the callback may start or cancel timers, so it is called without holding the lock
+        spinlock_unlock(spinlock_id_soft_timer);
+        if (timer->callback != 0) timer->callback(timer);
+        spinlock_lock(spinlock_id_soft_timer);
+    }
+
+    __alarm_update();
+
+    spinlock_unlock(spinlock_id_soft_timer);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
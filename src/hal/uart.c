@@ -2,90 +2,300 @@
 #include "hal/resets.h"
 #include "hal/clocks.h"
 #include "hal/gpio.h"
-#include "hal/fc0.h"
+#include "hal/dma.h"
+#include "hal/dfs.h"
+#include "hal/spinlock.h"
+#include "hal/multicore.h"
+#include "hal/timer.h"
 #include "utils/string.h"
+#include "utils/ring.h"
 
 //---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-#define MAX_PUTS_STRING_LEN     128     // maximum length of a single string to be sent by the uart_puts() function; protection against non-terminated strings
+#define RX_DMA_TRANSFER_COUNT   0xffffffff  // transfer count of the RX DMA; the channel is retriggered when it runs out
+#define UART_FIFO_DEPTH         32          // depth of the hardware TX and RX FIFOs
 
-//---- STRUCTS ---------------------------------------------------------------------------------------------------------------------------------------------------
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
 
-// TX and RX circular buffers data structure
-typedef struct {
+// TX ring: the producer is uart_putc() / uart_write(), the consumer is the TX service run by the UART IRQ, the DMA IRQ or a producer on the other core
+// RX ring: the producer is the UART IRQ (or the RX DMA), the consumer is uart_getc() / uart_read()
+static ring_t tx_fifo[2] = {0};       // UART transmit FIFO buffer for UART0 and UART1
+static ring_t rx_fifo[2] = {0};       // UART receive FIFO buffer for UART0 and UART1
 
-    volatile char     *data;        // buffer to store data; this is provided by the calee od a uart_init function
-             uint32_t size;         // size of the provided buffer
-    volatile uint32_t head;         // position where the next byte will be pushed onto
-    volatile uint32_t tail;         // position from where the next byte will be popped from
-    volatile bool     is_full;      // set when the head meets the tail after pushing
+static int8_t tx_dma_channel[2] = {-1, -1};         // DMA channel feeding the transmitter; -1 if the transmitter is interrupt driven
+static volatile uint32_t tx_dma_span[2] = {0};      // number of bytes the DMA is currently transmitting; 0 if the DMA is idle
 
-} uart_fifo_t;
+static int8_t rx_dma_channel[2] = {-1, -1};             // DMA channel streaming received data into the RX fifo; -1 if the receiver is interrupt driven
+static volatile uint32_t rx_dma_base[2] = {0};          // number of bytes received by the RX DMA in the previous (completed) transfers
+static soft_timer_t rx_idle_timer[2] = {0};             // one-shot timer detecting the end of a burst received by the RX DMA
+static uint32_t rx_idle_head[2] = {0};                  // RX DMA write position at the previous idle timer expiry
 
-//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+static volatile uint32_t rx_overruns[2] = {0};          // number of received bytes lost because the RX fifo was full
 
-static uart_fifo_t tx_fifo[2] = {0};       // UART transmit FIFO buffer for UART0 and UART0
-static uart_fifo_t rx_fifo[2] = {0};       // UART receive FIFO buffer for UART0 and UART1
+static uint32_t uart_baudrate[2] = {0};                 // baud rate of the initialized UARTs; 0 if the UART is not initialized
+static volatile bool tx_held[2] = {false};              // the transmitter is held back while the clocks are being changed
+static uint8_t uart_irq_core[2] = {0};                  // core that enabled the UART IRQ in its NVIC
 
 //---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
 
-static force_inline void __fifo_push(uart_fifo_t *fifo, char data) {
+// returns 0 if argument is UART0; returns 1 if argument is UART1
+#define uart_get_index(uart) (uart == UART1)
+
+// the TX lock serializes the TX service (the consumer of the TX fifo), which may run on both cores; the producer pushes without it.
+// The RX lock serializes the consumers of the RX fifo with the RX DMA head updates
+#define uart_tx_lock(index) ((index) ? spinlock_id_uart1_tx : spinlock_id_uart0_tx)
+#define uart_rx_lock(index) ((index) ? spinlock_id_uart1_rx : spinlock_id_uart0_rx)
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// hands the next contiguous block of the TX fifo to the DMA; does nothing if the DMA is still busy or there is no data
+static void __tx_dma_start(uint8_t index) {
+
+    if (tx_dma_span[index] != 0) return;
 
-    fifo->data[fifo->head++] = data;
+    volatile uint8_t *block;
+    uint32_t span = ring_peek_contiguous(&tx_fifo[index], &block);
+    if (span == 0) return;
 
-    if (fifo->head == fifo->size) fifo->head = 0;
-    if (fifo->head == fifo->tail) fifo->is_full = true;
+    tx_dma_span[index] = span;
+    dma_channel_transfer_from(tx_dma_channel[index], block, span);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-static force_inline char __fifo_pop(uart_fifo_t *fifo) {
+// called from the DMA IRQ when a block has been transmitted; releases the block from the TX fifo and starts the next one
+static void __tx_dma_complete(uint8_t channel) {
+
+    uint8_t index = (channel == tx_dma_channel[1]);
+
+    spinlock_lock(uart_tx_lock(index));
+
+    ring_skip(&tx_fifo[index], tx_dma_span[index]);
+    tx_dma_span[index] = 0;
 
-    char data = fifo->data[fifo->tail++];
-    if (fifo->tail == fifo->size) fifo->tail = 0;
-    fifo->is_full = false;
+    __tx_dma_start(index);
 
-    return data;
+    spinlock_unlock(uart_tx_lock(index));
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-static force_inline bool __fifo_has_data(uart_fifo_t *fifo) {
+// moves data from the TX fifo to the hardware: tops up the hardware TX FIFO or starts the next DMA block. Called with the TX lock held
+static void __uart_tx_service(uint8_t index) {
 
-    return ((fifo->head != fifo->tail) || fifo->is_full);
+    if (tx_held[index]) return;
+
+    if (tx_dma_channel[index] >= 0) __tx_dma_start(index);
+
+    else {
+
+        UART_t *uart = index ? UART1 : UART0;
+        uint8_t data;
+
+        while (bit_is_clear(uart->FR, UART_FR_TXFF) && ring_pop(&tx_fifo[index], &data)) uart->DR = data;
+    }
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-static force_inline bool __fifo_is_full(uart_fifo_t *fifo) {
+// makes the TX service pick up data the producer has just pushed to the TX fifo
+static void __uart_tx_kick(uint8_t index) {
+
+    // a DMA block is in flight; its completion IRQ starts the next one
+    if (tx_dma_channel[index] >= 0 && tx_dma_span[index] != 0) return;
 
-    return (fifo->is_full);
+    // on the core owning the UART IRQ the handler runs the service
+    if (multicore_get_core_num() == uart_irq_core[index]) {
+
+        NVIC_SetPendingIRQ(index ? UART1_IRQ : UART0_IRQ);
+        return;
+    }
+
+    // an NVIC pend only reaches the calling core, so the other core runs the service itself
+    uint32_t primask = spinlock_lock_irqsave(uart_tx_lock(index));
+    __uart_tx_service(index);
+    spinlock_unlock_irqrestore(uart_tx_lock(index), primask);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-static force_inline void __fifo_flush(uart_fifo_t *fifo) {
+// publishes the bytes written by the RX DMA to the RX fifo by moving its head; the RX DMA is the producer of the RX fifo,
+// so the head is simply the total number of bytes it has received. Called with the RX lock held
+static void __rx_dma_sync(uint8_t index) {
+
+    uint32_t base, transfer_count;
+
+    // the DMA IRQ may retrigger the channel in between the reads; repeat until the base and the transfer count belong together
+    do {
 
-    fifo->tail = fifo->head;
-    fifo->is_full = false;
+        base = rx_dma_base[index];
+        transfer_count = DMA->CH[rx_dma_channel[index]].TRANS_COUNT;
+
+    } while (base != rx_dma_base[index]);
+
+    rx_fifo[index].head = base + (RX_DMA_TRANSFER_COUNT - transfer_count);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// returns 0 if argument is UART0; returns 1 if argument is UART1
-#define uart_get_index(uart) (uart == UART1)
+// the RX DMA does not stop when the RX fifo is full but overwrites data that was not read yet; in that case the remaining content
+// is unreliable, so it is dropped and the lost bytes are counted. Called by the consumer of the RX fifo
+static void __rx_dma_check_overrun(uint8_t index) {
+
+    uint32_t count = ring_count(&rx_fifo[index]);
+    if (count <= ring_size(&rx_fifo[index])) return;
+
+    rx_overruns[index] += count;
+    ring_flush(&rx_fifo[index]);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns true if the RX fifo contains data; picks up the data the RX DMA has written so far. Called with the RX lock held
+static bool __uart_rx_available(uint8_t index) {
+
+    if (rx_dma_channel[index] >= 0) {
+
+        __rx_dma_sync(index);
+        __rx_dma_check_overrun(index);
+    }
+
+    return (!ring_is_empty(&rx_fifo[index]));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called from the DMA IRQ when the RX DMA has used up its transfer count; retriggers the channel, the write address continues where it stopped
+static void __rx_dma_complete(uint8_t channel) {
+
+    uint8_t index = (channel == rx_dma_channel[1]);
+
+    rx_dma_base[index] += RX_DMA_TRANSFER_COUNT;
+    DMA->CH[channel].AL1_TRANS_COUNT_TRIG = RX_DMA_TRANSFER_COUNT;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the time to transfer one character (start bit, 8 data bits and stop bit) at the baud rate [us]
+static inline uint32_t __uart_char_time_us(uint32_t baudrate) {
+
+    return ((10 * 1000000 + baudrate - 1) / baudrate);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+static void __rx_idle_timer_expired(soft_timer_t *timer);
+
+// arms the idle timer for UART_RX_IDLE_CHARS character times; returns false if no soft timer is available
+static inline bool __rx_idle_timer_arm(uint8_t index) {
+
+    return soft_timer_start(&rx_idle_timer[index], UART_RX_IDLE_CHARS * __uart_char_time_us(uart_baudrate[index]), 0, __rx_idle_timer_expired);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called from the UART IRQ when the first bytes of a burst arrive in RX DMA mode; hands the receiver to the DMA and arms the idle timer.
+// If no soft timer is available the DMA keeps the receiver, the data is then published when the RX fifo is polled
+static void __rx_dma_wake(UART_t *uart) {
+
+    uint8_t index = uart_get_index(uart);
+
+    spinlock_lock(uart_rx_lock(index));
+
+    atomic_clear_bits(uart->IMSC, UART_IMSC_RXIM | UART_IMSC_RTIM);
+    atomic_set_bits(uart->DMACR, UART_DMACR_RXDMAE);
+
+    __rx_dma_sync(index);
+    rx_idle_head[index] = rx_fifo[index].head;
+
+    spinlock_unlock(uart_rx_lock(index));
+
+    __rx_idle_timer_arm(index);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called by the soft timer UART_RX_IDLE_CHARS character times after the RX DMA took over; publishes the received data and re-arms while the DMA
+// keeps receiving. Once the line is idle, the receiver is handed back to the RX interrupts, so an idle line costs no interrupts at all; bytes
+// arriving after that wait in the hardware RX FIFO and raise the RX level or the receive timeout interrupt, which wakes the DMA again
+static void __rx_idle_timer_expired(soft_timer_t *timer) {
+
+    uint8_t index = (timer == &rx_idle_timer[1]);
+    UART_t *uart = index ? UART1 : UART0;
+    if (rx_dma_channel[index] < 0) return;
+
+    spinlock_lock(uart_rx_lock(index));
+
+    __rx_dma_sync(index);
+    bool receiving = (rx_fifo[index].head != rx_idle_head[index]);
+    rx_idle_head[index] = rx_fifo[index].head;
+
+    if (!receiving) {
+
+        // the read back makes sure the DREQ is gone before the RX interrupts take over
+        atomic_clear_bits(uart->DMACR, UART_DMACR_RXDMAE);
+        (void)uart->DMACR;
+
+        __rx_dma_sync(index);
+        atomic_set_bits(uart->IMSC, UART_IMSC_RXIM | UART_IMSC_RTIM);
+    }
+
+    spinlock_unlock(uart_rx_lock(index));
+
+    if (receiving) __rx_idle_timer_arm(index);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// called by the DFS service around a clk_peri change; the transmitters are held and drained before the change, so no character is sent
+// with a half changed clock, and resumed after the baud rate divisors of the initialized UARTs have been recalculated
+static void __uart_clock_changed(enum dfs_event event, uint32_t clk_sys_hz) {
+
+    (void)clk_sys_hz;
+
+    for (uint8_t index = 0; index < 2; index++) {
+
+        UART_t *uart = index ? UART1 : UART0;
+        if (uart_baudrate[index] == 0) continue;
+
+        if (event == dfs_pre_change) {
+
+            // no new data reaches the hardware TX FIFO; a DMA block in progress is paused by its DREQ and continues after the change
+            uint32_t primask = spinlock_lock_irqsave(uart_tx_lock(index));
+            tx_held[index] = true;
+            if (tx_dma_channel[index] >= 0) atomic_clear_bits(uart->DMACR, UART_DMACR_TXDMAE);
+            spinlock_unlock_irqrestore(uart_tx_lock(index), primask);
+
+            // the hardware FIFO and the shift register empty within FIFO depth + 1 character times
+            uint64_t deadline = timer_get_us() + (UART_FIFO_DEPTH + 1) * __uart_char_time_us(uart_baudrate[index]);
+            while (bit_is_set(uart->FR, UART_FR_BUSY) && timer_get_us() < deadline);
+
+        } else {
+
+            uart_set_baudrate(uart, uart_baudrate[index]);
+
+            uint32_t primask = spinlock_lock_irqsave(uart_tx_lock(index));
+            tx_held[index] = false;
+            if (tx_dma_channel[index] >= 0) atomic_set_bits(uart->DMACR, UART_DMACR_TXDMAE);
+            spinlock_unlock_irqrestore(uart_tx_lock(index), primask);
+
+            __uart_tx_kick(index);
+        }
+    }
+}
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// initializes the UART hardware
-void uart_init(UART_t *uart, uint32_t baudrate, uint8_t tx_gpio, uint8_t rx_gpio, char *tx_buffer, uint32_t tx_buffer_size, char *rx_buffer, uint32_t rx_buffer_size) {
+// initializes the UART hardware; the buffer sizes must be powers of two. Returns false if no buffer is provided or a buffer size is not a power of two
+bool uart_init(UART_t *uart, uint32_t baudrate, uint8_t tx_gpio, uint8_t rx_gpio, char *tx_buffer, uint32_t tx_buffer_size, char *rx_buffer, uint32_t rx_buffer_size) {
 
-    if (tx_buffer == 0 && rx_buffer == 0) return;           // TX buffer nor RX buffer is provided, nothing to initialize
-    if (tx_buffer != 0 && tx_buffer_size == 0) return;      // TX buffer size is 0
-    if (rx_buffer != 0 && rx_buffer_size == 0) return;      // RX buffer size is 0
+    if (tx_buffer == 0 && rx_buffer == 0) return false;     // TX buffer nor RX buffer is provided, nothing to initialize
+    if (tx_buffer != 0 && !ring_size_is_valid(tx_buffer_size)) return false;   // TX buffer size is not a power of two
+    if (rx_buffer != 0 && !ring_size_is_valid(rx_buffer_size)) return false;   // RX buffer size is not a power of two
 
     // take UART block out of reset
     uart_deinit(uart);
+    dfs_register_notifier(__uart_clock_changed);
     resets_unreset_block(uart_get_index(uart) ? RESETS_UART1 : RESETS_UART0);
 
     // set gpio function to UART
@@ -93,48 +303,182 @@ void uart_init(UART_t *uart, uint32_t baudrate, uint8_t tx_gpio, uint8_t rx_gpio
     gpio_set_function(rx_gpio, GPIO_FUNC_UART);
 
     // transmit enable and receive enable if a respective fifo was provided by the user
-    if (tx_buffer != 0) set_bits(uart->CR, UART_CR_TXE);
-    if (rx_buffer != 0) set_bits(uart->CR, UART_CR_RXE);
+    if (tx_buffer != 0) atomic_set_bits(uart->CR, UART_CR_TXE);
+    if (rx_buffer != 0) atomic_set_bits(uart->CR, UART_CR_RXE);
+
+    // set the baud rate and the word length to 8 bits
+    uart_set_baudrate(uart, baudrate);
+	atomic_write_masked(uart->LCR_H, 0b11, UART_LCR_H_WLEN_MASK, UART_LCR_H_WLEN_LSB);
+
+    // enable the 32-byte hardware FIFOs; the TX interrupt fires when the TX FIFO drains to 1/4, the RX interrupt when the RX FIFO fills to 1/2
+    // the leftover RX bytes below the RX level are picked up by the receive timeout interrupt
+    atomic_set_bits(uart->LCR_H, UART_LCR_H_FEN);
+    atomic_write_masked(uart->IFLS, UART_IFLS_VAL_1_4, UART_IFLS_TXIFLSEL_MASK, UART_IFLS_TXIFLSEL_LSB);
+    atomic_write_masked(uart->IFLS, UART_IFLS_VAL_1_2, UART_IFLS_RXIFLSEL_MASK, UART_IFLS_RXIFLSEL_LSB);
+
+    atomic_set_bits(uart->CR, UART_CR_UARTEN);     // enable the UART
+
+    if (tx_buffer != 0) ring_init(&tx_fifo[uart_get_index(uart)], tx_buffer, tx_buffer_size);
+    if (rx_buffer != 0) ring_init(&rx_fifo[uart_get_index(uart)], rx_buffer, rx_buffer_size);
+
+    // enable the TX, RX, RX timeout and RX overrun interrupts and enable the UARTx IRQ in NVIC
+    atomic_set_bits(uart->IMSC, UART_IMSC_TXIM | UART_IMSC_RXIM | UART_IMSC_RTIM | UART_IMSC_OEIM);
+    NVIC_EnableIRQ(uart_get_index(uart) ? UART1_IRQ : UART0_IRQ);         // enable the UART IRQ in NVIC
+    NVIC_SetPriority(uart_get_index(uart) ? UART1_IRQ : UART0_IRQ, 0);
+    uart_irq_core[uart_get_index(uart)] = multicore_get_core_num();
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// deinitializes the UART hardware
+void uart_deinit(UART_t *uart) {
+
+    // stop the DMA requests of a DMA driven UART (the block is out of reset then); the channels are aborted before the block is reset,
+    // so no paused transfer is left behind
+    if (tx_dma_channel[uart_get_index(uart)] >= 0 || rx_dma_channel[uart_get_index(uart)] >= 0) atomic_clear_bits(uart->DMACR, UART_DMACR_TXDMAE | UART_DMACR_RXDMAE);
+
+    // release the DMA channel if the transmitter was DMA driven
+    if (tx_dma_channel[uart_get_index(uart)] >= 0) {
+
+        dma_channel_unclaim(tx_dma_channel[uart_get_index(uart)]);
+        tx_dma_channel[uart_get_index(uart)] = -1;
+        tx_dma_span[uart_get_index(uart)] = 0;
+    }
+
+    tx_held[uart_get_index(uart)] = false;
+
+    // the fifos are detached, so a write to a deinitialized UART is dropped instead of writing through a stale buffer
+    tx_fifo[uart_get_index(uart)] = (ring_t){0};
+    rx_fifo[uart_get_index(uart)] = (ring_t){0};
+
+    // release the DMA channel if the receiver was DMA driven
+    if (rx_dma_channel[uart_get_index(uart)] >= 0) {
+
+        soft_timer_cancel(&rx_idle_timer[uart_get_index(uart)]);
+        dma_channel_unclaim(rx_dma_channel[uart_get_index(uart)]);
+        rx_dma_channel[uart_get_index(uart)] = -1;
+    }
+
+    resets_reset_block(uart_get_index(uart) ? RESETS_UART1 : RESETS_UART0);
+    uart_baudrate[uart_get_index(uart)] = 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// sets the baud rate according to the current clk_peri frequency
+void uart_set_baudrate(UART_t *uart, uint32_t baudrate) {
+
+    uart_baudrate[uart_get_index(uart)] = baudrate;
 
     // configure the baud rate divisors
     // baud divisor is CLK_PERI * (1/16) / baud
     // by using the formula CLK_PERI * 4 / baud, we get the value shifted left by 6 bits (64x larger)
     // the top bits become the integer part of BRD and the bottom 6 bits become the fractional part
-    uint32_t baud_divisor = 4 * fc0_get_hz(fc0_clk_peri) / baudrate;
+    uint32_t baud_divisor = 4 * clocks_get_hz(clk_peri) / baudrate;
 	uart->IBRD = baud_divisor >> 6;
 	uart->FBRD = baud_divisor & 0b111111;
 
-    // set the word length to 8 bits
-	write_masked(uart->LCR_H, 0b11, UART_LCR_H_WLEN_MASK, UART_LCR_H_WLEN_LSB);
-    set_bits(uart->CR, UART_CR_UARTEN);     // enable the UART
+    // the divisors are latched by a write to LCR_H
+    uart->LCR_H = uart->LCR_H;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-    tx_fifo[uart_get_index(uart)].data = tx_buffer;
-    rx_fifo[uart_get_index(uart)].data = rx_buffer;
-    tx_fifo[uart_get_index(uart)].size = tx_buffer_size;
-    rx_fifo[uart_get_index(uart)].size = rx_buffer_size;
-    if (tx_buffer != 0) __fifo_flush(&tx_fifo[uart_get_index(uart)]);
-    if (rx_buffer != 0) __fifo_flush(&rx_fifo[uart_get_index(uart)]);
+// switches the transmitter to DMA mode: contiguous blocks of the TX fifo are transmitted by a DMA channel paced by the UART TX DREQ,
+// so there is one interrupt per block instead of one per byte; the DMA needs to be initialized first. Returns false if no DMA channel is available
+bool uart_enable_tx_dma(UART_t *uart) {
 
-    // enable the TX and RX interrupts and enable the UARTx IRQ in NVIC
-    set_bits(uart->IMSC, UART_IMSC_TXIM | UART_IMSC_RXIM);
-    NVIC_EnableIRQ(uart_get_index(uart) ? UART1_IRQ : UART0_IRQ);         // enable the UART IRQ in NVIC
-    NVIC_SetPriority(uart_get_index(uart) ? UART1_IRQ : UART0_IRQ, 0);
+    uint8_t index = uart_get_index(uart);
+    if (tx_dma_channel[index] >= 0) return true;
+
+    int8_t channel = dma_channel_claim();
+    if (channel < 0) return false;
+
+    dma_channel_configure(channel, 0, &uart->DR, 0, DMA_CTRL_EN | DMA_CTRL_INCR_READ | DMA_CTRL_DATA_SIZE_VAL_BYTE | ((index ? DMA_DREQ_UART1_TX : DMA_DREQ_UART0_TX) << DMA_CTRL_TREQ_SEL_LSB));
+
+    NVIC_DisableIRQ(index ? UART1_IRQ : UART0_IRQ);
+
+    tx_dma_span[index] = 0;
+    tx_dma_channel[index] = channel;
+    dma_channel_set_callback(channel, __tx_dma_complete);
+
+    atomic_clear_bits(uart->IMSC, UART_IMSC_TXIM);         // the TX empty interrupt is no longer needed, the transfers are started by software
+    atomic_set_bits(uart->DMACR, UART_DMACR_TXDMAE);
+
+    NVIC_EnableIRQ(index ? UART1_IRQ : UART0_IRQ);
+    NVIC_SetPendingIRQ(index ? UART1_IRQ : UART0_IRQ);   // start transmitting data that is already waiting in the fifo
+
+    return true;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// deinitializes the UART hardware
-void uart_deinit(UART_t *uart) {
+// switches the receiver to DMA mode: a DMA channel paced by the UART RX DREQ streams the received data into the RX buffer using the DMA ring wrap.
+// While the line is idle the DMA request is off and the RX interrupts watch the hardware FIFO; the first bytes of a burst hand the receiver to
+// the DMA until the one-shot idle timer sees no progress for UART_RX_IDLE_CHARS character times. The RX buffer size must be a power of two (max 32 kB)
+// and the buffer must be aligned to its size; the DMA needs to be initialized first. Flushes the RX buffer. Returns false if the buffer is not suitable
+// or no DMA channel is available
+bool uart_enable_rx_dma(UART_t *uart) {
 
-    resets_reset_block(uart_get_index(uart) ? RESETS_UART1 : RESETS_UART0);
+    uint8_t index = uart_get_index(uart);
+    if (rx_dma_channel[index] >= 0) return true;
+
+    ring_t *fifo = &rx_fifo[index];
+    if (fifo->data == 0 || ring_size(fifo) < 2 || ring_size(fifo) > 32768) return false;
+    if (((uint32_t)fifo->data & fifo->mask) != 0) return false;        // buffer is not aligned to its size
+
+    int8_t channel = dma_channel_claim();
+    if (channel < 0) return false;
+
+    // ring size is log2 of the buffer size
+    uint32_t ring_bits = 0;
+    while ((1UL << ring_bits) < ring_size(fifo)) ring_bits++;
+
+    NVIC_DisableIRQ(index ? UART1_IRQ : UART0_IRQ);
+
+    fifo->head = 0;
+    fifo->tail = 0;
+    rx_dma_base[index] = 0;
+
+    // the channel is published after its transfer count is set, so the RX fifo is never synced from a stale count
+    dma_channel_configure(channel, &uart->DR, fifo->data, RX_DMA_TRANSFER_COUNT, DMA_CTRL_EN | DMA_CTRL_INCR_WRITE | DMA_CTRL_RING_SEL | (ring_bits << DMA_CTRL_RING_SIZE_LSB) |
+                          DMA_CTRL_DATA_SIZE_VAL_BYTE | ((index ? DMA_DREQ_UART1_RX : DMA_DREQ_UART0_RX) << DMA_CTRL_TREQ_SEL_LSB));
+    rx_dma_channel[index] = channel;
+    dma_channel_set_callback(channel, __rx_dma_complete);
+    dma_channel_start(channel);
+
+    // the channel waits for the DMA request, which the RX interrupt enables when data arrives; the RX level is lowered to 1/8,
+    // so the DMA takes over early and the hardware FIFO keeps 28 bytes of margin for the interrupt latency
+    atomic_write_masked(uart->IFLS, UART_IFLS_VAL_1_8, UART_IFLS_RXIFLSEL_MASK, UART_IFLS_RXIFLSEL_LSB);
+    atomic_set_bits(uart->IMSC, UART_IMSC_RXIM | UART_IMSC_RTIM);
+
+    NVIC_EnableIRQ(index ? UART1_IRQ : UART0_IRQ);
+
+    return true;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// returns the number of received bytes that were lost because the RX buffer was full
+uint32_t uart_get_rx_overruns(UART_t *uart) {
+
+    return (rx_overruns[uart_get_index(uart)]);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
 // returns true, if the RX buffer contains new data
-volatile bool uart_has_data(UART_t *uart) {
+bool uart_has_data(UART_t *uart) {
+
+    uint8_t index = uart_get_index(uart);
 
-    return (__fifo_has_data(&rx_fifo[uart_get_index(uart)]));
+    uint32_t primask = spinlock_lock_irqsave(uart_rx_lock(index));
+    bool available = __uart_rx_available(index);
+    spinlock_unlock_irqrestore(uart_rx_lock(index), primask);
+
+    return available;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -142,23 +486,25 @@ volatile bool uart_has_data(UART_t *uart) {
 // flushes the RX buffer
 void uart_flush(UART_t *uart) {
 
-    __fifo_flush(&rx_fifo[uart_get_index(uart)]);
+    uint8_t index = uart_get_index(uart);
+
+    uint32_t primask = spinlock_lock_irqsave(uart_rx_lock(index));
+    if (rx_dma_channel[index] >= 0) __rx_dma_sync(index);
+    ring_flush(&rx_fifo[index]);
+    spinlock_unlock_irqrestore(uart_rx_lock(index), primask);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// transmits one byte via UART; waits if the TX fifo is full
+// transmits one byte via UART; skips the byte if the TX fifo is full
 void uart_putc(UART_t *uart, char c) {
 
+    uint8_t index = uart_get_index(uart);
+    if (tx_fifo[index].data == 0) return;       // the transmitter is not initialized
+
     // don't send if the fifo is full, busy waiting here would potentially cause deadline misses of other tasks or looping indefinetly in case of a fault
     // therefore skipping the bytes is the better option here
-    if (__fifo_is_full(&tx_fifo[uart_get_index(uart)])) return;
-
-    // disable interrupts while pushing to preserve the correct byte order
-    __disable_irq();
-    __fifo_push(&tx_fifo[uart_get_index(uart)], c);
-    NVIC_SetPendingIRQ(uart_get_index(uart) ? UART1_IRQ : UART0_IRQ);   // trigger the TX empty interrupt
-    __enable_irq();
+    if (ring_push(&tx_fifo[index], c)) __uart_tx_kick(index);
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -173,16 +519,24 @@ void uart_puti(UART_t *uart, int num) {
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// transmits a null-terminated string via UART; waits if the TX fifo is full
+// transmits a null-terminated string via UART; the part of the string that does not fit into the TX fifo is skipped
 void uart_puts(UART_t *uart, const char *str) {
 
-    uint32_t bytes_sent = 0;        // limit bytes sent in a single function; protection against infinite looping in case a non-terminated string is passed
+    uart_write(uart, str, strlen((char*)str));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-    while (*str != '\0' && bytes_sent < MAX_PUTS_STRING_LEN) {
-        
-        uart_putc(uart, *str++);
-        bytes_sent++;
-    }
+// copies up to len bytes to the TX fifo and starts the transmission; returns the number of bytes accepted (the rest did not fit into the fifo)
+uint32_t uart_write(UART_t *uart, const void *data, uint32_t len) {
+
+    uint8_t index = uart_get_index(uart);
+    if (tx_fifo[index].data == 0) return 0;     // the transmitter is not initialized
+
+    uint32_t written = ring_write(&tx_fifo[index], data, len);
+    if (written != 0) __uart_tx_kick(index);        // start the transmission once for the whole block
+
+    return written;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
@@ -190,33 +544,69 @@ void uart_puts(UART_t *uart, const char *str) {
 // reads one byte from the RX buffer; returns -1 if there is no new data
 int16_t uart_getc(UART_t *uart) {
 
-    if (!__fifo_has_data(&rx_fifo[uart_get_index(uart)])) return -1;
-    return __fifo_pop(&rx_fifo[uart_get_index(uart)]);
+    uint8_t index = uart_get_index(uart);
+    uint8_t data;
+    bool popped = false;
+
+    uint32_t primask = spinlock_lock_irqsave(uart_rx_lock(index));
+    if (__uart_rx_available(index)) popped = ring_pop(&rx_fifo[index], &data);
+    spinlock_unlock_irqrestore(uart_rx_lock(index), primask);
+
+    return (popped ? data : -1);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// copies up to len bytes from the RX buffer; returns the number of bytes read
+uint32_t uart_read(UART_t *uart, void *data, uint32_t len) {
+
+    uint8_t index = uart_get_index(uart);
+    uint32_t read = 0;
+
+    uint32_t primask = spinlock_lock_irqsave(uart_rx_lock(index));
+    if (__uart_rx_available(index)) read = ring_read(&rx_fifo[index], data, len);
+    spinlock_unlock_irqrestore(uart_rx_lock(index), primask);
+
+    return read;
 }
 
 //---- IRQ HANDLERS ----------------------------------------------------------------------------------------------------------------------------------------------
 
 static force_inline void uart_handler(UART_t *uart) {
 
-    // transmit fifo empty
-    if (bit_is_set(uart->FR, UART_FR_TXFE)) {
+    // top up the hardware TX FIFO or start a new DMA block if the DMA is idle
+    spinlock_lock(uart_tx_lock(uart_get_index(uart)));
+    __uart_tx_service(uart_get_index(uart));
+    spinlock_unlock(uart_tx_lock(uart_get_index(uart)));
+
+    // in DMA mode the RX interrupts are only unmasked while the line is idle; the first bytes of a burst hand the receiver to the DMA
+    if (rx_dma_channel[uart_get_index(uart)] >= 0) {
 
-        if (__fifo_has_data(&tx_fifo[uart_get_index(uart)])) uart->DR = __fifo_pop(&tx_fifo[uart_get_index(uart)]);
+        if (bit_is_set(uart->MIS, UART_MIS_RXMIS | UART_MIS_RTMIS)) __rx_dma_wake(uart);
     }
 
-    // interrupt was triggered by RX
-    if (bit_is_set(uart->RIS, UART_RIS_RXRIS)) {
+    // interrupt was triggered by RX (RX FIFO level reached or receive timeout)
+    else if (bit_is_set(uart->RIS, UART_RIS_RXRIS | UART_RIS_RTRIS)) {
+
+        // drain the hardware RX FIFO; always read the data register, otherwise the hardware would overrun
+        while (bit_is_clear(uart->FR, UART_FR_RXFE)) {
 
-        if (!__fifo_is_full(&rx_fifo[uart_get_index(uart)])) __fifo_push(&rx_fifo[uart_get_index(uart)], uart->DR);
+            char data = uart->DR;
+
+            if (!ring_push(&rx_fifo[uart_get_index(uart)], data)) rx_overruns[uart_get_index(uart)]++;
+        }
     }
 
+    // the hardware has lost a byte because it was not read in time
+    if (bit_is_set(uart->RIS, UART_RIS_OERIS)) rx_overruns[uart_get_index(uart)]++;
+
     // acknowledge the IRQ
     uart->ICR = 0xffff;
 }
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// triggered when the hardware has finished transmitting or when new data is received
+// triggered when the hardware TX FIFO runs low, when the RX FIFO fills up or when the receive line goes idle
 void UART0_Handler() {
 
     uart_handler(UART0);
@@ -224,7 +614,7 @@ void UART0_Handler() {
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-// triggered when the hardware has finished transmitting or when new data is received
+// triggered when the hardware TX FIFO runs low, when the RX FIFO fills up or when the receive line goes idle
 void UART1_Handler() {
 
     uart_handler(UART1);
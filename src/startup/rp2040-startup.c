@@ -1,5 +1,6 @@
 #include <stdint.h>
 #include "startup/vector_table.h"
+#include "hal/rom.h"
 
 /*
  *  Universal startup file
@@ -18,8 +19,8 @@ extern int main();
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-// entry point
-void Reset_Handler() {
+// entry point; the copy loops must not be turned into memcpy() / memset() calls, those are placed in SRAM and are not there yet
+__attribute__((optimize("no-tree-loop-distribute-patterns"))) void Reset_Handler() {
 
     // copy the .data segment from FLASH to SRAM
     uint32_t *p_src = &_la_data;
@@ -35,6 +36,8 @@ void Reset_Handler() {
         *p_dst = 0x00000000;
     }
 
+    rom_init();     // resolve the bootrom functions before the application (and the float helpers) can use them
+
     main();     // branch to main
 
     while (1);
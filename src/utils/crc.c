@@ -0,0 +1,64 @@
+#include "utils/crc.h"
+
+//---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+// continues a CRC-32 calculation over len bytes; the result is not inverted
+uint32_t crc32_update(uint32_t crc, const void *data, uint32_t len) {
+
+    const uint8_t *bytes = data;
+
+    while (len--) {
+
+        crc ^= *bytes++;
+        for (uint8_t bit = 0; bit < 8; bit++) crc = (crc >> 1) ^ (0xedb88320 & -(crc & 1));
+    }
+
+    return crc;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// continues a CRC-16-CCITT calculation over len bytes
+uint16_t crc16_ccitt_update(uint16_t crc, const void *data, uint32_t len) {
+
+    const uint8_t *bytes = data;
+
+    while (len--) {
+
+        crc ^= (uint16_t)(*bytes++) << 8;
+        for (uint8_t bit = 0; bit < 8; bit++) crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+
+    return crc;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the CRC-32 of len bytes
+uint32_t crc32(const void *data, uint32_t len) {
+
+    return ~crc32_update(CRC32_INIT, data, len);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the CRC-16-CCITT of len bytes
+uint16_t crc16_ccitt(const void *data, uint32_t len) {
+
+    return crc16_ccitt_update(CRC16_CCITT_INIT, data, len);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the 32-bit sum of len bytes
+uint32_t checksum_sum(const void *data, uint32_t len) {
+
+    const uint8_t *bytes = data;
+    uint32_t sum = 0;
+
+    while (len--) sum += *bytes++;
+
+    return sum;
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
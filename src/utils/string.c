@@ -1,11 +1,107 @@
 #include "utils/string.h"
+#include "rp2040.h"
 
 //---- FUNCTIONS -------------------------------------------------------------------------------------------------------------------------------------------------
 
-void *memcpy (void *dest, const void *src, uint32_t len) {
+// copies 16 bytes per iteration with LDM / STM; both pointers must be word aligned. The C version lets the host tests build this file
+static inline __attribute__((always_inline)) void __copy_blocks(uint32_t **dest, const uint32_t **src, uint32_t blocks) {
+
+#ifdef __thumb__
+	__asm volatile (
+		"1:	ldmia %[s]!, {r3, r4, r5, r6}	\n"
+		"	stmia %[d]!, {r3, r4, r5, r6}	\n"
+		"	subs %[n], #1					\n"
+		"	bne 1b							\n"
+		: [d] "+l" (*dest), [s] "+l" (*src), [n] "+l" (blocks)
+		:
+		: "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+	while (blocks--) for (uint32_t i = 0; i < 4; i++) *(*dest)++ = *(*src)++;
+#endif
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// fills 16 bytes per iteration with STM; the pointer must be word aligned. The C version lets the host tests build this file
+static inline __attribute__((always_inline)) void __fill_blocks(uint32_t **dest, uint32_t word, uint32_t blocks) {
+
+#ifdef __thumb__
+	__asm volatile (
+		"	mov r3, %[w]					\n"
+		"	mov r4, %[w]					\n"
+		"	mov r5, %[w]					\n"
+		"	mov r6, %[w]					\n"
+		"1:	stmia %[d]!, {r3, r4, r5, r6}	\n"
+		"	subs %[n], #1					\n"
+		"	bne 1b							\n"
+		: [d] "+l" (*dest), [n] "+l" (blocks)
+		: [w] "l" (word)
+		: "r3", "r4", "r5", "r6", "cc", "memory");
+#else
+	while (blocks--) for (uint32_t i = 0; i < 4; i++) *(*dest)++ = word;
+#endif
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// copies the bytes in ascending order; whole words are moved once the destination is aligned, source misalignment is handled by shifting
+ramfunc void *memcpy (void *dest, const void *src, uint32_t len) {
+
+	uint8_t *d = dest;
+	const uint8_t *s = src;
+
+	if (len >= 8) {
+
+		// align the destination
+		while ((uint32_t)d & 3) {
+
+			*d++ = *s++;
+			len--;
+		}
+
+		uint32_t offset = (uint32_t)s & 3;
 
-	char *d = dest;
-	const char *s = src;
+		if (offset == 0) {
+
+			uint32_t *dw = (uint32_t*)d;
+			const uint32_t *sw = (const uint32_t*)s;
+
+			if (len >= 16) {
+
+				__copy_blocks(&dw, &sw, len / 16);
+				len &= 15;
+			}
+
+			while (len >= 4) {
+
+				*dw++ = *sw++;
+				len -= 4;
+			}
+
+			d = (uint8_t*)dw;
+			s = (const uint8_t*)sw;
+
+		} else {
+
+			// the Cortex-M0+ has no unaligned loads; aligned source words are merged, the last one read contains the next source byte
+			uint32_t *dw = (uint32_t*)d;
+			const uint32_t *sw = (const uint32_t*)(s - offset);
+			uint32_t right = offset * 8;
+			uint32_t left = 32 - right;
+			uint32_t word = *sw++;
+
+			while (len >= 4) {
+
+				uint32_t next = *sw++;
+				*dw++ = (word >> right) | (next << left);
+				word = next;
+				len -= 4;
+			}
+
+			d = (uint8_t*)dw;
+			s = (const uint8_t*)sw - 4 + offset;
+		}
+	}
 
 	while (len--) *d++ = *s++;
 	return dest;
@@ -13,11 +109,78 @@ void *memcpy (void *dest, const void *src, uint32_t len) {
 
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 
-void *memset (void *dest, int val, uint32_t len) {
+// copies the bytes correctly even if the areas overlap
+ramfunc void *memmove (void *dest, const void *src, uint32_t len) {
+
+	uint8_t *d = dest;
+	const uint8_t *s = src;
+
+	// memcpy() copies in ascending order and reads each word before writing below it, which is safe if the destination is below the source
+	if (d <= s || d >= s + len) return memcpy(dest, src, len);
+
+	d += len;
+	s += len;
+
+	// descending copy; whole words if both ends are aligned alike
+	if ((((uint32_t)d ^ (uint32_t)s) & 3) == 0) {
+
+		while (len > 0 && ((uint32_t)d & 3)) {
+
+			*--d = *--s;
+			len--;
+		}
+
+		uint32_t *dw = (uint32_t*)d;
+		const uint32_t *sw = (const uint32_t*)s;
+
+		while (len >= 4) {
+
+			*--dw = *--sw;
+			len -= 4;
+		}
+
+		d = (uint8_t*)dw;
+		s = (const uint8_t*)sw;
+	}
+
+	while (len--) *--d = *--s;
+	return dest;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+
+// fills the memory with the byte; 16 bytes per iteration with STM once the destination is aligned
+ramfunc void *memset (void *dest, int val, uint32_t len) {
+
+	uint8_t *d = dest;
+
+	if (len >= 8) {
+
+		while ((uint32_t)d & 3) {
+
+			*d++ = val;
+			len--;
+		}
 
-	unsigned char *ptr = dest;
+		uint32_t word = (uint32_t)(uint8_t)val * 0x01010101u;
+		uint32_t *dw = (uint32_t*)d;
+
+		if (len >= 16) {
+
+			__fill_blocks(&dw, word, len / 16);
+			len &= 15;
+		}
+
+		while (len >= 4) {
+
+			*dw++ = word;
+			len -= 4;
+		}
+
+		d = (uint8_t*)dw;
+	}
 
-	while (len-- > 0) *ptr++ = val;
+	while (len--) *d++ = val;
 	return dest;
 }
 
@@ -0,0 +1,192 @@
+/*
+ *  Host test of the 64-bit division (src/hal/divider.c)
+ *  Martin Kopka 2024
+ *
+ *  The SIO divider is replaced by a C stand-in with the same results (including the division by zero), and divider_divmod_u64(),
+ *  divider_divmod_s64() and __divider_div64_32() are compared against the native 64-bit division. The operands have random bit lengths,
+ *  so all the paths (32 / 32, 64 / 32, 64 / 64 bits) and the estimate corrections of the long division are exercised, followed by edge values.
+ *
+ *  gcc -O2 -Wall -Wextra -Iinclude tests/host/divider_test.c -o divider_test && ./divider_test [operands]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+//---- DIVIDER STAND-IN ------------------------------------------------------------------------------------------------------------------------------------------
+
+// replaces hal/divider.h; the saved state is not needed, since the stand-in has no state
+#define _HAL_DIVIDER_H_
+
+typedef struct {
+
+    uint32_t quotient;
+    uint32_t remainder;
+
+} divmod_u32_t;
+
+typedef struct {
+
+    uint32_t dividend;
+    uint32_t divisor;
+    uint32_t remainder;
+    uint32_t quotient;
+
+} divider_state_t;
+
+uint64_t divider_divmod_u64(uint64_t numerator, uint64_t denominator, uint64_t *remainder);
+int64_t divider_divmod_s64(int64_t numerator, int64_t denominator, int64_t *remainder);
+
+// the SIO divider returns all ones and the dividend as the remainder for a division by zero
+static inline divmod_u32_t divider_divmod_u32(uint32_t dividend, uint32_t divisor) {
+
+    divmod_u32_t result;
+
+    if (divisor == 0) {
+
+        result.quotient = 0xffffffff;
+        result.remainder = dividend;
+
+    } else {
+
+        result.quotient = dividend / divisor;
+        result.remainder = dividend % divisor;
+    }
+
+    return result;
+}
+
+static inline bool divider_is_dirty(void) {return false;}
+static inline void divider_save_state(divider_state_t *state) {(void)state;}
+static inline void divider_restore_state(const divider_state_t *state) {(void)state;}
+
+#include "../../src/hal/divider.c"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define DEFAULT_OPERANDS    20000000UL
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint64_t random_state = 0x0123456789abcdefULL;
+static unsigned long failures = 0;
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// xorshift64
+static uint64_t __random(void) {
+
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 7;
+    random_state ^= random_state << 17;
+    return random_state;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns a random number with a random bit length of 1 to 64 bits
+static uint64_t __random_operand(void) {
+
+    uint32_t bits = 1 + __random() % 64;
+    uint64_t value = __random();
+
+    return (bits == 64) ? value : (value & ((1ULL << bits) - 1));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// checks the unsigned and the signed division of the operands
+static void __check(uint64_t n, uint64_t d) {
+
+    uint64_t remainder;
+    uint64_t quotient = divider_divmod_u64(n, d, &remainder);
+
+    uint64_t expected_quotient = (d == 0) ? ~(uint64_t)0 : n / d;
+    uint64_t expected_remainder = (d == 0) ? n : n % d;
+
+    if (quotient != expected_quotient || remainder != expected_remainder) {
+
+        if (failures++ < 10) printf("u64: %016llx / %016llx = %016llx rem %016llx, expected %016llx rem %016llx\n", (unsigned long long)n, (unsigned long long)d,
+                                    (unsigned long long)quotient, (unsigned long long)remainder, (unsigned long long)expected_quotient, (unsigned long long)expected_remainder);
+    }
+
+    // the signed division is undefined for a zero divisor and overflows for INT64_MIN / -1
+    int64_t sn = (int64_t)n, sd = (int64_t)d;
+    if (sd == 0 || (sn == INT64_MIN && sd == -1)) return;
+
+    int64_t s_remainder;
+    int64_t s_quotient = divider_divmod_s64(sn, sd, &s_remainder);
+
+    if (s_quotient != sn / sd || s_remainder != sn % sd) {
+
+        if (failures++ < 10) printf("s64: %lld / %lld = %lld rem %lld, expected %lld rem %lld\n", (long long)sn, (long long)sd,
+                                    (long long)s_quotient, (long long)s_remainder, (long long)(sn / sd), (long long)(sn % sd));
+    }
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// checks the 64 / 32-bit long division directly; high must be lower than the divisor
+static void __check_div64_32(uint32_t high, uint32_t low, uint32_t divisor) {
+
+    uint64_t n = ((uint64_t)high << 32) | low;
+    uint32_t remainder;
+    uint32_t quotient = __divider_div64_32(high, low, divisor, &remainder);
+
+    if (quotient != n / divisor || remainder != n % divisor) {
+
+        if (failures++ < 10) printf("div64_32: %016llx / %08x = %08x rem %08x, expected %08llx rem %08llx\n", (unsigned long long)n, divisor, quotient, remainder,
+                                    (unsigned long long)(n / divisor), (unsigned long long)(n % divisor));
+    }
+}
+
+//---- MAIN ------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+
+    unsigned long operands = (argc > 1) ? strtoul(argv[1], 0, 0) : DEFAULT_OPERANDS;
+
+    for (unsigned long i = 0; i < operands; i++) {
+
+        __check(__random_operand(), __random_operand());
+
+        uint32_t divisor = __random_operand() | 1;
+        __check_div64_32(__random() % divisor, __random(), divisor);
+    }
+
+    // edge values: zero, one, powers of two and their neighbours, the extremes of both signs
+    static uint64_t edges[3 * 64 + 4];
+    uint32_t count = 0;
+
+    edges[count++] = 0;
+    edges[count++] = ~(uint64_t)0;
+    edges[count++] = INT64_MAX;
+    edges[count++] = (uint64_t)INT64_MIN;
+
+    for (uint32_t bit = 0; bit < 64; bit++) {
+
+        edges[count++] = (1ULL << bit);
+        edges[count++] = (1ULL << bit) - 1;
+        edges[count++] = (1ULL << bit) + 1;
+    }
+
+    for (uint32_t i = 0; i < count; i++) for (uint32_t j = 0; j < count; j++) __check(edges[i], edges[j]);
+
+    // the largest quotients of the long division, where the estimates need the most corrections
+    for (uint32_t i = 0; i < count; i++) {
+
+        uint32_t divisor = (uint32_t)edges[i];
+        if (divisor == 0) continue;
+
+        __check_div64_32(divisor - 1, 0xffffffff, divisor);
+        __check_div64_32(divisor - 1, 0, divisor);
+        __check_div64_32(divisor >> 1, 0x80000000, divisor);
+    }
+
+    printf("divider_test: %lu random operand pairs, %u edge values, %lu failures\n", operands, count, failures);
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
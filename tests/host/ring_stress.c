@@ -0,0 +1,170 @@
+/*
+ *  Host stress test of the SPSC ring buffer (utils/ring.h)
+ *  Martin Kopka 2024
+ *
+ *  A producer thread and a consumer thread move a long pseudo-random sequence through a small ring, mixing the single byte, the block
+ *  and the contiguous peek/skip accessors with random lengths, so the indices wrap and the ring runs both full and empty. The consumer
+ *  checks every byte against the sequence. The ring orders its accesses with a compiler barrier only, which matches the Cortex-M0+ and
+ *  the x86 memory model, so the test runs on x86 hosts only.
+ *
+ *  gcc -O2 -Wall -Wextra -Iinclude -pthread tests/host/ring_stress.c -o ring_stress && ./ring_stress [bytes]
+*/
+
+#if !defined(__x86_64__) && !defined(__i386__)
+#error "the ring buffer relies on the store ordering of the Cortex-M0+, which only x86 hosts provide as well"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+
+// the target string functions take a 32-bit length; the host uses the libc ones
+#define _UTILS_STRING_H_
+#include "utils/ring.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define RING_SIZE           64          // small, so the indices wrap often
+#define MAX_BLOCK           (RING_SIZE + 16)    // blocks longer than the ring exercise the partial writes and reads
+#define DEFAULT_BYTES       200000000UL
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint8_t buffer[RING_SIZE];
+static ring_t ring;
+
+static uint64_t total_bytes;
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns the byte at the position of the test sequence
+static inline uint8_t __sequence(uint64_t position) {
+
+    uint64_t x = position * 0x9e3779b97f4a7c15ULL;
+    return (uint8_t)(x >> 56);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// xorshift32; each thread has its own state
+static inline uint32_t __random(uint32_t *state) {
+
+    uint32_t x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return (*state = x);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pushes the test sequence with ring_push() and ring_write()
+static void *__producer(void *arg) {
+
+    (void)arg;
+
+    uint32_t state = 0x12345678;
+    uint64_t position = 0;
+    uint8_t block[MAX_BLOCK];
+
+    while (position < total_bytes) {
+
+        uint32_t len;
+
+        if (__random(&state) & 1) len = ring_push(&ring, __sequence(position));
+
+        else {
+
+            len = 1 + __random(&state) % MAX_BLOCK;
+            if (len > total_bytes - position) len = total_bytes - position;
+
+            for (uint32_t i = 0; i < len; i++) block[i] = __sequence(position + i);
+            len = ring_write(&ring, block, len);
+        }
+
+        // let the consumer run on a single core host
+        if (len == 0) sched_yield();
+
+        position += len;
+    }
+
+    return 0;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// pops the test sequence with ring_pop(), ring_read() and ring_peek_contiguous() / ring_skip(); returns the number of wrong bytes
+static void *__consumer(void *arg) {
+
+    uint64_t *errors = arg;
+
+    uint32_t state = 0x87654321;
+    uint64_t position = 0;
+    uint8_t block[MAX_BLOCK];
+
+    while (position < total_bytes) {
+
+        uint32_t mode = __random(&state) % 3;
+        uint32_t len = 0;
+
+        if (mode == 0) {
+
+            uint8_t data;
+            if (ring_pop(&ring, &data)) {
+
+                if (data != __sequence(position)) (*errors)++;
+                len = 1;
+            }
+
+        } else if (mode == 1) {
+
+            len = ring_read(&ring, block, 1 + __random(&state) % MAX_BLOCK);
+            for (uint32_t i = 0; i < len; i++) if (block[i] != __sequence(position + i)) (*errors)++;
+
+        } else {
+
+            volatile uint8_t *data;
+            len = ring_peek_contiguous(&ring, &data);
+            for (uint32_t i = 0; i < len; i++) if (data[i] != __sequence(position + i)) (*errors)++;
+            ring_skip(&ring, len);
+        }
+
+        // the count seen by the consumer must never exceed the ring size
+        if (ring_count(&ring) > RING_SIZE) (*errors)++;
+
+        if (len == 0) sched_yield();
+
+        position += len;
+    }
+
+    return 0;
+}
+
+//---- MAIN ------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+
+    total_bytes = (argc > 1) ? strtoull(argv[1], 0, 0) : DEFAULT_BYTES;
+
+    // start close to the 32-bit wrap of the free-running indices
+    ring_init(&ring, buffer, RING_SIZE);
+    ring.head = ring.tail = 0xffffff00;
+
+    uint64_t errors = 0;
+    pthread_t producer, consumer;
+
+    pthread_create(&producer, 0, __producer, 0);
+    pthread_create(&consumer, 0, __consumer, &errors);
+    pthread_join(producer, 0);
+    pthread_join(consumer, 0);
+
+    if (!ring_is_empty(&ring)) errors++;
+
+    printf("ring_stress: %llu bytes, %llu errors\n", (unsigned long long)total_bytes, (unsigned long long)errors);
+
+    return (errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
@@ -0,0 +1,166 @@
+/*
+ *  Host test of memcpy(), memset() and memmove() (src/utils/string.c)
+ *  Martin Kopka 2024
+ *
+ *  The routines are built for the host (the LDM / STM blocks fall back to C loops) under different names and compared against
+ *  the libc ones over random sizes, source and destination alignments, fill values and overlaps. Guard bytes around the
+ *  destination catch writes outside of it.
+ *
+ *  gcc -O2 -Wall -Wextra -Wno-pointer-to-int-cast -fno-builtin -fno-tree-loop-distribute-patterns -Iinclude tests/host/string_test.c -o string_test && ./string_test [iterations]
+*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+
+// the target routines are renamed, so they can run next to the libc ones; rp2040.h is not needed
+#define _RP2040_H_
+#define ramfunc
+#define memcpy  target_memcpy
+#define memmove target_memmove
+#define memset  target_memset
+#define strlen  target_strlen
+#define strcmp  target_strcmp
+#define itoa    target_itoa
+#define atoi    target_atoi
+#define strrev  target_strrev
+
+#include "../../src/utils/string.c"
+
+#undef memcpy
+#undef memmove
+#undef memset
+#undef strlen
+#undef strcmp
+#undef itoa
+#undef atoi
+#undef strrev
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define MAX_LEN             1024        // longest tested block
+#define GUARD               16          // guard bytes on each side of the destination
+#define BUFFER_SIZE         (GUARD + 8 + MAX_LEN + GUARD)
+#define DEFAULT_ITERATIONS  200000UL
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint8_t source[BUFFER_SIZE] __attribute__((aligned(8)));
+static uint8_t expected[BUFFER_SIZE] __attribute__((aligned(8)));
+static uint8_t actual[BUFFER_SIZE] __attribute__((aligned(8)));
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// returns a random length; short blocks (the byte paths and the alignment prologues) are favoured
+static uint32_t __random_len(void) {
+
+    return ((rand() & 3) ? (uint32_t)rand() % 64 : (uint32_t)rand() % (MAX_LEN + 1));
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// fills the buffer with random bytes
+static void __randomize(uint8_t *buffer, uint32_t len) {
+
+    for (uint32_t i = 0; i < len; i++) buffer[i] = rand();
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// compares the result with the libc one; returns true if they match
+static bool __check(const char *name, uint32_t len, uint32_t dest_offset, uint32_t src_offset) {
+
+    if (memcmp(expected, actual, BUFFER_SIZE) == 0) return true;
+
+    printf("%s failed: len %u, dest offset %u, src offset %u\n", name, len, dest_offset, src_offset);
+    return false;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// copies a random block between random alignments
+static bool __test_memcpy(void) {
+
+    uint32_t len = __random_len();
+    uint32_t dest_offset = GUARD + rand() % 8;
+    uint32_t src_offset = rand() % 8;
+
+    __randomize(source, BUFFER_SIZE);
+    __randomize(expected, BUFFER_SIZE);
+    memcpy(actual, expected, BUFFER_SIZE);
+
+    memcpy(&expected[dest_offset], &source[src_offset], len);
+    if (target_memcpy(&actual[dest_offset], &source[src_offset], len) != &actual[dest_offset]) return false;
+
+    return __check("memcpy", len, dest_offset, src_offset);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// fills a random block at a random alignment; the value is any int, only its low byte is stored
+static bool __test_memset(void) {
+
+    uint32_t len = __random_len();
+    uint32_t dest_offset = GUARD + rand() % 8;
+    int val = rand() - RAND_MAX / 2;
+
+    __randomize(expected, BUFFER_SIZE);
+    memcpy(actual, expected, BUFFER_SIZE);
+
+    memset(&expected[dest_offset], val, len);
+    if (target_memset(&actual[dest_offset], val, len) != &actual[dest_offset]) return false;
+
+    return __check("memset", len, dest_offset, 0);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// moves a random block within one buffer, so the areas overlap in either direction or not at all
+static bool __test_memmove(void) {
+
+    uint32_t len = __random_len();
+    uint32_t dest_offset = GUARD + rand() % (MAX_LEN + 8 - len + 1);
+    uint32_t src_offset = GUARD + rand() % (MAX_LEN + 8 - len + 1);
+
+    // mostly close to each other, so the areas overlap
+    if (rand() & 1) {
+
+        src_offset = dest_offset + rand() % 17 - 8;
+        if (src_offset < GUARD) src_offset = GUARD;
+        if (src_offset > GUARD + MAX_LEN + 8 - len) src_offset = GUARD + MAX_LEN + 8 - len;
+    }
+
+    __randomize(expected, BUFFER_SIZE);
+    memcpy(actual, expected, BUFFER_SIZE);
+
+    memmove(&expected[dest_offset], &expected[src_offset], len);
+    if (target_memmove(&actual[dest_offset], &actual[src_offset], len) != &actual[dest_offset]) return false;
+
+    return __check("memmove", len, dest_offset, src_offset);
+}
+
+//---- MAIN ------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(int argc, char **argv) {
+
+    unsigned long iterations = (argc > 1) ? strtoul(argv[1], 0, 0) : DEFAULT_ITERATIONS;
+    unsigned long failures = 0;
+
+    srand(1);
+
+    for (unsigned long i = 0; i < iterations; i++) {
+
+        if (!__test_memcpy()) failures++;
+        if (!__test_memset()) failures++;
+        if (!__test_memmove()) failures++;
+
+        if (failures > 10) break;
+    }
+
+    printf("string_test: %lu iterations, %lu failures\n", iterations, failures);
+
+    return (failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------
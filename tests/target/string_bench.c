@@ -0,0 +1,172 @@
+/*
+ *  Throughput benchmark of memcpy(), memset() and memmove() (src/utils/string.c)
+ *  Martin Kopka 2024
+ *
+ *  Runs on the RP2040 at 125 MHz and prints the throughput of the routines in bytes per clk_sys cycle to UART0 (GPIO 0, 115200 baud),
+ *  next to a plain byte loop as the reference. The cycles are counted by SysTick with the IRQs masked; the cost of an empty measurement
+ *  is subtracted. Every size is measured with the source and destination word aligned and with the source one byte off.
+ *  Build it as the application together with the HAL sources and the startup code.
+*/
+
+#include "rp2040.h"
+#include "hal/clocks.h"
+#include "hal/uart.h"
+#include "utils/string.h"
+
+//---- CONSTANTS -------------------------------------------------------------------------------------------------------------------------------------------------
+
+#define BENCH_MAX_LEN       4096        // longest measured block
+#define BENCH_REPEAT        8           // measurements per case; the fastest one is reported
+
+//---- PRIVATE DATA ----------------------------------------------------------------------------------------------------------------------------------------------
+
+static uint32_t source[BENCH_MAX_LEN / 4 + 2];
+static uint32_t destination[BENCH_MAX_LEN / 4 + 2];
+
+static char tx_buffer[1024];
+
+static const uint32_t sizes[] = {16, 64, 256, 1024, 4096};
+
+//---- PRIVATE FUNCTIONS -----------------------------------------------------------------------------------------------------------------------------------------
+
+// reference: copies byte by byte; kept as a loop, so the compiler does not turn it into a memcpy() call
+__attribute__((optimize("no-tree-loop-distribute-patterns"))) ramfunc static void *__byte_copy(void *dest, const void *src, uint32_t len) {
+
+    uint8_t *d = dest;
+    const uint8_t *s = src;
+
+    while (len--) *d++ = *s++;
+    return dest;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// reference: fills byte by byte
+__attribute__((optimize("no-tree-loop-distribute-patterns"))) ramfunc static void *__byte_fill(void *dest, int val, uint32_t len) {
+
+    uint8_t *d = dest;
+
+    while (len--) *d++ = val;
+    return dest;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the clk_sys cycles elapsed since the start value of the SysTick down counter
+static inline uint32_t __cycles_since(uint32_t start) {
+
+    return ((start - SysTick->VAL) & SysTick_LOAD_RELOAD_Msk);
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the fewest cycles a copy routine takes; with len 0 and no routine, the cost of the measurement itself
+static uint32_t __measure_copy(void *(*copy)(void *, const void *, uint32_t), void *dest, const void *src, uint32_t len) {
+
+    uint32_t best = 0xffffffff;
+
+    for (uint32_t i = 0; i < BENCH_REPEAT; i++) {
+
+        __disable_irq();
+        uint32_t start = SysTick->VAL;
+        if (copy != 0) copy(dest, src, len);
+        uint32_t cycles = __cycles_since(start);
+        __enable_irq();
+
+        if (cycles < best) best = cycles;
+    }
+
+    return best;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// returns the fewest cycles a fill routine takes
+static uint32_t __measure_fill(void *(*fill)(void *, int, uint32_t), void *dest, uint32_t len) {
+
+    uint32_t best = 0xffffffff;
+
+    for (uint32_t i = 0; i < BENCH_REPEAT; i++) {
+
+        __disable_irq();
+        uint32_t start = SysTick->VAL;
+        fill(dest, 0x5a, len);
+        uint32_t cycles = __cycles_since(start);
+        __enable_irq();
+
+        if (cycles < best) best = cycles;
+    }
+
+    return best;
+}
+
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+// prints one result line: name, length, source offset, cycles and bytes per cycle with two decimals
+static void __report(const char *name, uint32_t len, uint32_t offset, uint32_t cycles) {
+
+    if (cycles == 0) cycles = 1;
+    uint32_t rate = len * 100 / cycles;
+
+    uart_puts(UART0, name);
+    uart_puts(UART0, " len ");
+    uart_puti(UART0, len);
+    uart_puts(UART0, " src +");
+    uart_puti(UART0, offset);
+    uart_puts(UART0, ": ");
+    uart_puti(UART0, cycles);
+    uart_puts(UART0, " cycles, ");
+    uart_puti(UART0, rate / 100);
+    uart_putc(UART0, '.');
+    uart_putc(UART0, '0' + (rate / 10) % 10);
+    uart_putc(UART0, '0' + rate % 10);
+    uart_puts(UART0, " bytes/cycle\r\n");
+
+    // let the TX fifo drain, so the output is not cut off
+    for (volatile uint32_t i = 0; i < 100000; i++);
+}
+
+//---- MAIN ------------------------------------------------------------------------------------------------------------------------------------------------------
+
+int main(void) {
+
+    clocks_configure(12000000, PLL_CONFIG_12MHZ_TO_125MHZ, PLL_CONFIG_12MHZ_TO_48MHZ);
+    uart_init(UART0, 115200, 0, 1, tx_buffer, sizeof(tx_buffer), 0, 0);
+
+    // SysTick free-running from the processor clock, without its interrupt
+    SysTick->LOAD = SysTick_LOAD_RELOAD_Msk;
+    SysTick->VAL = 0;
+    SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+
+    for (uint32_t i = 0; i < BENCH_MAX_LEN / 4 + 2; i++) source[i] = i * 0x9e3779b9;
+
+    uint32_t overhead = __measure_copy(0, 0, 0, 0);
+
+    uart_puts(UART0, "\r\nstring benchmark, clk_sys ");
+    uart_puti(UART0, clocks_get_hz(clk_sys) / 1000000);
+    uart_puts(UART0, " MHz\r\n");
+
+    for (uint32_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+
+        uint32_t len = sizes[i];
+
+        for (uint32_t offset = 0; offset < 2; offset++) {
+
+            const uint8_t *src = (const uint8_t*)source + offset;
+            uint8_t *dest = (uint8_t*)destination;
+
+            __report("memcpy   ", len, offset, __measure_copy(memcpy, dest, src, len) - overhead);
+            __report("byte copy", len, offset, __measure_copy(__byte_copy, dest, src, len) - overhead);
+
+            // overlapping, destination above the source: the descending path
+            __report("memmove  ", len, offset, __measure_copy(memmove, (uint8_t*)source + 4, (uint8_t*)source + offset, len) - overhead);
+        }
+
+        __report("memset   ", len, 0, __measure_fill(memset, destination, len) - overhead);
+        __report("byte fill", len, 0, __measure_fill(__byte_fill, destination, len) - overhead);
+    }
+
+    while (1);
+}
+
+//----------------------------------------------------------------------------------------------------------------------------------------------------------------